@@ -15,7 +15,7 @@
 #include <QDebug>
 
 AbstractCardItem::AbstractCardItem(const QString &_name, Player *_owner, int _id, QGraphicsItem *parent)
-    : ArrowTarget(_owner, parent), infoWidget(0), id(_id), name(_name), tapped(false), facedown(false), tapAngle(0), isHovered(false), realZValue(0)
+    : ArrowTarget(_owner, parent), infoWidget(0), id(_id), name(_name), tapped(false), facedown(false), tapAngle(0), isHovered(false), realZValue(0), faceDirty(true)
 {
     setCursor(Qt::OpenHandCursor);
     setFlag(ItemIsSelectable);
@@ -38,7 +38,7 @@ QRectF AbstractCardItem::boundingRect() const
 
 void AbstractCardItem::pixmapUpdated()
 {
-    update();
+    updateFace();
     emit sigPixmapUpdated();
 }
 
@@ -46,6 +46,7 @@ void AbstractCardItem::cardInfoUpdated()
 {
     info = db->getCard(name);
     connect(info, SIGNAL(pixmapUpdated()), this, SLOT(pixmapUpdated()));
+    updateFace();
 }
 
 void AbstractCardItem::setRealZValue(qreal _zValue)
@@ -157,18 +158,43 @@ void AbstractCardItem::paintPicture(QPainter *painter, const QSizeF &translatedS
     painter->restore();
 }
 
-void AbstractCardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*option*/, QWidget * /*widget*/)
+void AbstractCardItem::paintFace(QPainter *painter, const QSizeF &translatedSize)
 {
-    painter->save();
+    paintPicture(painter, translatedSize, 0);
+}
 
+void AbstractCardItem::updateFace()
+{
+    faceDirty = true;
+    update();
+}
+
+void AbstractCardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*option*/, QWidget * /*widget*/)
+{
     QSizeF translatedSize = getTranslatedSize(painter);
-    paintPicture(painter, translatedSize, tapAngle);
-    
+    const QSize faceSize = translatedSize.toSize();
+    if (faceSize.isEmpty())
+        return;
+
+    // Tapping, animating and hovering only change how the face is put on screen,
+    // so it is only painted again when its contents or its size have changed.
+    if (faceDirty || (cachedFace.size() != faceSize)) {
+        cachedFace = QPixmap(faceSize);
+        cachedFace.fill(Qt::transparent);
+
+        QPainter facePainter(&cachedFace);
+        facePainter.setRenderHints(painter->renderHints());
+        facePainter.scale(translatedSize.width() / boundingRect().width(), translatedSize.height() / boundingRect().height());
+        paintFace(&facePainter, translatedSize);
+        faceDirty = false;
+    }
+
     painter->save();
-    painter->setRenderHint(QPainter::Antialiasing, false);
     transformPainter(painter, translatedSize, tapAngle);
+    painter->drawPixmap(QPointF(0, 0), cachedFace);
 
     if (isSelected() || isHovered) {
+        painter->setRenderHint(QPainter::Antialiasing, false);
         QPen pen;
         if (isHovered)
             pen.setColor(Qt::yellow);
@@ -181,8 +207,6 @@ void AbstractCardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *
     }
 
     painter->restore();
-
-    painter->restore();
 }
 
 void AbstractCardItem::setName(const QString &_name)
@@ -195,7 +219,7 @@ void AbstractCardItem::setName(const QString &_name)
     name = _name;
     info = db->getCard(name);
     connect(info, SIGNAL(pixmapUpdated()), this, SLOT(pixmapUpdated()));
-    update();
+    updateFace();
 }
 
 void AbstractCardItem::setHovered(bool _hovered)
@@ -215,7 +239,7 @@ void AbstractCardItem::setHovered(bool _hovered)
 void AbstractCardItem::setColor(const QString &_color)
 {
     color = _color;
-    update();
+    updateFace();
 }
 
 void AbstractCardItem::setTapped(bool _tapped, bool canAnimate)
@@ -236,7 +260,7 @@ void AbstractCardItem::setTapped(bool _tapped, bool canAnimate)
 void AbstractCardItem::setFaceDown(bool _facedown)
 {
     facedown = _facedown;
-    update();
+    updateFace();
     emit updateCardMenu(this);
 }
 
@@ -2,6 +2,7 @@
 #define ABSTRACTCARDITEM_H
 
 #include "arrowtarget.h"
+#include <QPixmap>
 
 class CardInfo;
 class CardInfoWidget;
@@ -25,10 +26,13 @@ protected:
 private:
     bool isHovered;
     qreal realZValue;
+    // the card as painted by paintFace(), not rotated, at the size it was last painted at
+    QPixmap cachedFace;
+    bool faceDirty;
 private slots:
     void pixmapUpdated();
     void cardInfoUpdated();
-    void callUpdate() { update(); }
+    void callUpdate() { updateFace(); }
 signals:
     void hovered(AbstractCardItem *card);
     void showCardInfoPopup(QPoint pos, QString cardName);
@@ -46,7 +50,7 @@ public:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
     CardInfo *getInfo() const { return info; }
     int getId() const { return id; }
-    void setId(int _id) { id = _id; }
+    void setId(int _id) { id = _id; updateFace(); }
     QString getName() const { return name; }
     void setName(const QString &_name = QString());
     qreal getRealZValue() const { return realZValue; }
@@ -62,6 +66,11 @@ public:
     void deleteCardInfoPopup() { emit deleteCardInfoPopup(name); }
 protected:
     void transformPainter(QPainter *painter, const QSizeF &translatedSize, int angle);
+    // Paints everything but the selection highlight into the cached face.
+    // The painter is scaled from item coordinates to the face pixmap.
+    virtual void paintFace(QPainter *painter, const QSizeF &translatedSize);
+    // Has to be called instead of update() when anything paintFace() draws changes.
+    void updateFace();
     void mousePressEvent(QGraphicsSceneMouseEvent *event);
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
     QVariant itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant &value);
@@ -20,7 +20,7 @@
 #include "client_metatypes.h"
 
 AbstractClient::AbstractClient(QObject *parent)
-    : QObject(parent), nextCmdId(0), status(StatusDisconnected)
+    : QObject(parent), nextCmdId(0), status(StatusDisconnected), batchEvents(false)
 {
     qRegisterMetaType<QVariant>("QVariant");
     qRegisterMetaType<CommandContainer>("CommandContainer");
@@ -29,6 +29,7 @@ AbstractClient::AbstractClient(QObject *parent)
     qRegisterMetaType<ClientStatus>("ClientStatus");
     qRegisterMetaType<RoomEvent>("RoomEvent");
     qRegisterMetaType<GameEventContainer>("GameEventContainer");
+    qRegisterMetaType<QList<ServerMessage> >("QList<ServerMessage>");
     qRegisterMetaType<Event_ServerIdentification>("Event_ServerIdentification");
     qRegisterMetaType<Event_ConnectionClosed>("Event_ConnectionClosed");
     qRegisterMetaType<Event_ServerShutdown>("Event_ServerShutdown");
@@ -53,6 +54,14 @@ AbstractClient::~AbstractClient()
 
 void AbstractClient::processProtocolItem(const ServerMessage &item)
 {
+    if (batchEvents) {
+        if (isBatchedEvent(item)) {
+            eventBatch.append(item);
+            return;
+        }
+        flushEventBatch();
+    }
+
     switch (item.message_type()) {
         case ServerMessage::RESPONSE: {
             const Response &response = item.response();
@@ -97,6 +106,31 @@ void AbstractClient::processProtocolItem(const ServerMessage &item)
     }
 }
 
+bool AbstractClient::isBatchedEvent(const ServerMessage &item)
+{
+    return (item.message_type() == ServerMessage::GAME_EVENT_CONTAINER) || (item.message_type() == ServerMessage::ROOM_EVENT);
+}
+
+void AbstractClient::processOwnedProtocolItem(ServerMessage &item)
+{
+    if (batchEvents && isBatchedEvent(item)) {
+        eventBatch.append(ServerMessage());
+        eventBatch.last().Swap(&item);
+    } else
+        processProtocolItem(item);
+}
+
+void AbstractClient::flushEventBatch()
+{
+    if (eventBatch.isEmpty())
+        return;
+
+    // The list is implicitly shared, so the messages are not copied again
+    // when the signal is queued to another thread.
+    emit eventBatchReceived(eventBatch);
+    eventBatch.clear();
+}
+
 void AbstractClient::setStatus(const ClientStatus _status)
 {
     QMutexLocker locker(&clientMutex);
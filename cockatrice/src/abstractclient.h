@@ -6,12 +6,12 @@
 #include <QMutex>
 #include "pb/response.pb.h"
 #include "pb/serverinfo_user.pb.h"
+#include "pb/server_message.pb.h"
 
 class PendingCommand;
 class CommandContainer;
 class RoomEvent;
 class GameEventContainer;
-class ServerMessage;
 class Event_ServerIdentification;
 class Event_AddToList;
 class Event_RemoveFromList;
@@ -44,6 +44,9 @@ signals:
     void roomEventReceived(const RoomEvent &event);
     // Game events
     void gameEventContainerReceived(const GameEventContainer &event);
+    // Room events and game event containers, in the order they were received in,
+    // if batchEvents is set
+    void eventBatchReceived(const QList<ServerMessage> &batch);
     // Session events
     void serverIdentificationEventReceived(const Event_ServerIdentification &event);
     void connectionClosedEventReceived(const Event_ConnectionClosed &event);
@@ -75,6 +78,16 @@ protected slots:
     void processProtocolItem(const ServerMessage &item);
 protected:
     QMap<int, PendingCommand *> pendingCommands;
+    // Room events and game event containers are collected in eventBatch
+    // instead of being emitted one by one, until flushEventBatch() is called.
+    // Any other message flushes the batch first, so the order is kept.
+    bool batchEvents;
+    QList<ServerMessage> eventBatch;
+    static bool isBatchedEvent(const ServerMessage &item);
+    // Like processProtocolItem(), but a batched message is swapped into
+    // eventBatch instead of being copied, which leaves item empty.
+    void processOwnedProtocolItem(ServerMessage &item);
+    void flushEventBatch();
     QString userName, password, email, country, realName, token;
     int gender;
     void setStatus(ClientStatus _status);
@@ -16,8 +16,15 @@
 #include <QDebug>
 #include <QImageReader>
 #include <QMessageBox>
+#include <QEventLoop>
+#include <QBuffer>
+#include <QRunnable>
+#if QT_VERSION < 0x050000
+#include <QDesktopServices>
+#else
+#include <QStandardPaths>
+#endif
 
-const int CardDatabase::versionNeeded = 3;
 const char* CardDatabase::TOKENS_SETNAME = "TK";
 
 static QXmlStreamWriter &operator<<(QXmlStreamWriter &xml, const CardSet *set)
@@ -213,26 +220,231 @@ CardSet *PictureToLoad::getCurrentSet() const
         return 0;
 }
 
+static void mirrorLevels(QList<QImage> &levels)
+{
+    for (int i = 0; i < levels.size(); ++i)
+        levels[i] = levels[i].mirrored(true, true);
+}
+
+/*
+ * Decodes a picture file, or downloaded picture data, on the loader's thread
+ * pool, and creates the pixmap cache levels from it. Downloaded pictures are
+ * saved to saveDir if they could be decoded. If a thumbnail cache is given,
+ * the thumbnails of the picture file are stored in it.
+ */
+class PictureDecoder : public QRunnable {
+private:
+    PictureLoader *loader;
+    ThumbnailCache *thumbnailCache;
+    CardInfo *card;
+    QString fileName;
+    QByteArray data;
+    QString saveDir, saveName;
+public:
+    PictureDecoder(PictureLoader *_loader, ThumbnailCache *_thumbnailCache, CardInfo *_card, const QString &_fileName)
+        : loader(_loader), thumbnailCache(_thumbnailCache), card(_card), fileName(_fileName) { }
+    PictureDecoder(PictureLoader *_loader, ThumbnailCache *_thumbnailCache, CardInfo *_card, const QByteArray &_data, const QString &_saveDir, const QString &_saveName)
+        : loader(_loader), thumbnailCache(_thumbnailCache), card(_card), data(_data), saveDir(_saveDir), saveName(_saveName) { }
+    void run();
+};
+
+void PictureDecoder::run()
+{
+    QImage image;
+    QString savedFileName;
+    const bool downloaded = fileName.isEmpty();
+
+    if (!downloaded) {
+        QImageReader imgReader(fileName);
+        imgReader.setDecideFormatFromContent(true);
+        imgReader.read(&image);
+    } else {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader imgReader;
+        imgReader.setDecideFormatFromContent(true);
+        imgReader.setDevice(&buffer);
+        QString extension = "." + imgReader.format(); //the format is determined prior to reading the QImageReader data into a QImage object, as that wipes the QImageReader buffer
+        if (extension == ".jpeg")
+            extension = ".jpg";
+
+        if (imgReader.read(&image) && !saveDir.isEmpty()) {
+            if (!QDir().mkpath(saveDir)) {
+                qDebug() << saveDir + " could not be created.";
+            } else {
+                QFile newPic(saveDir + "/" + saveName + extension);
+                if (newPic.open(QIODevice::WriteOnly)) {
+                    newPic.write(data);
+                    newPic.close();
+                    savedFileName = newPic.fileName();
+                }
+            }
+        }
+    }
+
+    QList<QImage> levels = CardPixmapCache::createLevels(image);
+    const QString sourceFileName = downloaded ? savedFileName : fileName;
+    if (thumbnailCache && !levels.isEmpty() && !sourceFileName.isEmpty())
+        thumbnailCache->store(sourceFileName, levels);
+    if (card->getUpsideDownArt())
+        mirrorLevels(levels);
+
+    QMetaObject::invokeMethod(loader, "pictureDecoded", Qt::QueuedConnection, Q_ARG(CardInfo *, card), Q_ARG(QList<QImage>, levels), Q_ARG(bool, downloaded), Q_ARG(QString, savedFileName));
+}
+
+/*
+ * Reads the thumbnails of a picture file, which are shown until the
+ * picture itself has been decoded.
+ */
+class ThumbnailDecoder : public QRunnable {
+private:
+    PictureLoader *loader;
+    ThumbnailCache *thumbnailCache;
+    CardInfo *card;
+    QString fileName;
+public:
+    ThumbnailDecoder(PictureLoader *_loader, ThumbnailCache *_thumbnailCache, CardInfo *_card, const QString &_fileName)
+        : loader(_loader), thumbnailCache(_thumbnailCache), card(_card), fileName(_fileName) { }
+    void run();
+};
+
+void ThumbnailDecoder::run()
+{
+    QList<QImage> thumbnails;
+    if (!thumbnailCache->load(fileName, thumbnails))
+        return;
+    if (card->getUpsideDownArt())
+        mirrorLevels(thumbnails);
+
+    QMetaObject::invokeMethod(loader, "thumbnailDecoded", Qt::QueuedConnection, Q_ARG(CardInfo *, card), Q_ARG(QList<QImage>, thumbnails));
+}
+
 QStringList PictureLoader::md5Blacklist = QStringList()
     << "db0c48db407a907c16ade38de048a441"; // card back returned by gatherer when card is not found
 
+const int PictureLoader::maxDownloadsPerHost = 4;
+
+static QString thumbnailCacheDir()
+{
+#if QT_VERSION < 0x050000
+    return QDesktopServices::storageLocation(QDesktopServices::CacheLocation) + "/thumbnails";
+#else
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+#endif
+}
+
 PictureLoader::PictureLoader(const QString &__picsPath, bool _picDownload, bool _picDownloadHq, QObject *parent)
     : QObject(parent),
-      _picsPath(__picsPath), picDownload(_picDownload), picDownloadHq(_picDownloadHq),
-      downloadRunning(false), loadQueueRunning(false)
+      _picsPath(__picsPath), thumbnailCache(thumbnailCacheDir()),
+      picDownload(_picDownload), picDownloadHq(_picDownloadHq), loadQueueRunning(false)
 {
+    qRegisterMetaType<CardInfo *>("CardInfo*");
+    qRegisterMetaType<QList<QImage> >("QList<QImage>");
     connect(this, SIGNAL(startLoadQueue()), this, SLOT(processLoadQueue()), Qt::QueuedConnection);
 
     networkManager = new QNetworkAccessManager(this);
     connect(networkManager, SIGNAL(finished(QNetworkReply *)), this, SLOT(picDownloadFinished(QNetworkReply *)));
+
+    decoderPool.setMaxThreadCount(QThread::idealThreadCount());
 }
 
 PictureLoader::~PictureLoader()
 {
+    // The decoders post their results to this object.
+    decoderPool.waitForDone();
+
     // This does not work with the destroyed() signal as this destructor is called after the main event loop is done.
     thread()->quit();
 }
 
+void PictureLoader::indexPictureFiles(const QString &picsPath)
+{
+    pictureFiles.clear();
+    indexedPicsPath = picsPath;
+
+    QDir picsDir(picsPath);
+    QDirIterator picsIterator(picsPath, QDir::Files, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+    while (picsIterator.hasNext())
+        addPictureFile(picsDir.relativeFilePath(picsIterator.next()), picsIterator.filePath());
+
+    qDebug() << "Indexed" << pictureFiles.size() << "picture file names in" << picsPath;
+}
+
+void PictureLoader::addPictureFile(const QString &relativePath, const QString &filePath)
+{
+    // Files are looked up by name, with or without their extension,
+    // like QImageReader does when given a file name without one.
+    const QString key = pictureFileKey(relativePath);
+    pictureFiles.insert(key, filePath);
+
+    const int extensionStart = key.lastIndexOf('.');
+    if ((extensionStart > key.lastIndexOf('/')) && !pictureFiles.contains(key.left(extensionStart)))
+        pictureFiles.insert(key.left(extensionStart), filePath);
+}
+
+QString PictureLoader::pictureFileKey(const QString &relativePath)
+{
+#if defined(Q_OS_WIN) || defined(Q_OS_MAC)
+    return relativePath.toLower();
+#else
+    return relativePath;
+#endif
+}
+
+QString PictureLoader::probePictureFile(const QString &relativePath)
+{
+    // Picks up files created after the index was built, e.g. copied in by hand.
+    if (pictureFileSuffixes.isEmpty()) {
+        const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+        for (int i = 0; i < formats.size(); ++i)
+            pictureFileSuffixes.append("." + QString(formats[i]));
+    }
+
+    const QString basePath = indexedPicsPath + "/" + relativePath;
+    for (int i = 0; i < pictureFileSuffixes.size(); ++i) {
+        const QString filePath = basePath + pictureFileSuffixes[i];
+        if (QFile::exists(filePath)) {
+            addPictureFile(relativePath + pictureFileSuffixes[i], filePath);
+            return filePath;
+        }
+    }
+    return QString();
+}
+
+QString PictureLoader::findPictureFile(const PictureToLoad &pic)
+{
+    QString setName = pic.getSetName();
+    QString correctedCardname = pic.getCard()->getCorrectedName();
+
+    //The list of paths, relative to the pictures folder, in which to search for images
+    QStringList picsPaths = QStringList() << "CUSTOM/" + correctedCardname;
+
+    if(!setName.isEmpty())
+    {
+        picsPaths   << setName + "/" + correctedCardname
+                    << "downloadedPics/" + setName + "/" + correctedCardname;
+    }
+
+    for (int i = 0; i < picsPaths.size(); i++) {
+        const QString key = pictureFileKey(picsPaths[i]);
+        QHash<QString, QString>::const_iterator file = pictureFiles.constFind(key);
+        if (file == pictureFiles.constEnd())
+            file = pictureFiles.constFind(key + ".full");
+        if (file != pictureFiles.constEnd())
+            return file.value();
+    }
+
+    for (int i = 0; i < picsPaths.size(); i++) {
+        QString fileName = probePictureFile(picsPaths[i]);
+        if (fileName.isEmpty())
+            fileName = probePictureFile(picsPaths[i] + ".full");
+        if (!fileName.isEmpty())
+            return fileName;
+    }
+
+    return QString();
+}
+
 void PictureLoader::processLoadQueue()
 {
     if (loadQueueRunning)
@@ -241,79 +453,76 @@ void PictureLoader::processLoadQueue()
     loadQueueRunning = true;
     forever {
         mutex.lock();
-        if (loadQueue.isEmpty()) {
+        PictureToLoad pic;
+        if (!loadQueue.isEmpty())
+            pic = loadQueue.takeFirst();
+        else if (!prefetchQueue.isEmpty())
+            pic = prefetchQueue.takeFirst();
+        else {
             mutex.unlock();
             loadQueueRunning = false;
             return;
         }
-        cardBeingLoaded = loadQueue.takeFirst();
+        const QString picsPath = _picsPath;
         mutex.unlock();
 
-        QString setName = cardBeingLoaded.getSetName();
-        QString correctedCardname = cardBeingLoaded.getCard()->getCorrectedName();
-        qDebug() << "Trying to load picture (set: " << setName << " card: " << correctedCardname << ")";
-
-        //The list of paths to the folders in which to search for images
-        QList<QString> picsPaths = QList<QString>() << _picsPath + "/CUSTOM/" + correctedCardname;
+        if (picsPath != indexedPicsPath)
+            indexPictureFiles(picsPath);
 
-        if(!setName.isEmpty())
-        {
-            picsPaths   << _picsPath + "/" + setName + "/" + correctedCardname
-                        << _picsPath + "/downloadedPics/" + setName + "/" + correctedCardname;
+        QString fileName = findPictureFile(pic);
+        if (fileName.isEmpty()) {
+            pictureNotFound(pic);
+            continue;
         }
 
-        QImage image;
-        QImageReader imgReader;
-        imgReader.setDecideFormatFromContent(true);
-        bool found = false;
-
-        //Iterates through the list of paths, searching for images with the desired name with any QImageReader-supported extension
-        for (int i = 0; i < picsPaths.length() && !found; i ++) {
-            imgReader.setFileName(picsPaths.at(i));
-            if (imgReader.read(&image)) {
-                qDebug() << "Picture found on disk (set: " << setName << " card: " << correctedCardname << ")";
-                emit imageLoaded(cardBeingLoaded.getCard(), image);
-                found = true;
-                break;
-            }
-            imgReader.setFileName(picsPaths.at(i) + ".full");
-            if (imgReader.read(&image)) {
-                qDebug() << "Picture.full found on disk (set: " << setName << " card: " << correctedCardname << ")";
-                emit imageLoaded(cardBeingLoaded.getCard(), image);
-                found = true;
-            }
-        }
+        qDebug() << "Picture found on disk (set: " << pic.getSetName() << " card: " << pic.getCard()->getCorrectedName() << ")";
+        cardsBeingDecoded.insert(pic.getCard(), pic);
+        // The thumbnails go ahead of the pictures waiting to be decoded;
+        // pictures without thumbnails get them stored when decoded.
+        if (thumbnailCache.contains(fileName)) {
+            decoderPool.start(new ThumbnailDecoder(this, &thumbnailCache, pic.getCard(), fileName), 1);
+            decoderPool.start(new PictureDecoder(this, 0, pic.getCard(), fileName));
+        } else
+            decoderPool.start(new PictureDecoder(this, &thumbnailCache, pic.getCard(), fileName));
+    }
+}
 
-        if (!found) {
-            if (picDownload) {
-                qDebug() << "Picture NOT found, trying to download (set: " << setName << " card: " << correctedCardname << ")";
-                cardsToDownload.append(cardBeingLoaded);
-                cardBeingLoaded=0;
-                if (!downloadRunning)
-                    startNextPicDownload();
-            } else {
-                if (cardBeingLoaded.nextSet())
-                {
-                    qDebug() << "Picture NOT found and download disabled, moving to next set (newset: " << setName << " card: " << correctedCardname << ")";
-                    mutex.lock();
-                    loadQueue.prepend(cardBeingLoaded);
-                    cardBeingLoaded=0;
-                    mutex.unlock();
-                } else {
-                    qDebug() << "Picture NOT found, download disabled, no more sets to try: BAILING OUT (oldset: " << setName << " card: " << correctedCardname << ")";
-                    emit imageLoaded(cardBeingLoaded.getCard(), QImage());
-                }
-            }
-        }
+void PictureLoader::pictureNotFound(PictureToLoad &pic)
+{
+    QString setName = pic.getSetName();
+    QString correctedCardname = pic.getCard()->getCorrectedName();
+
+    if (picDownload) {
+        qDebug() << "Picture NOT found, trying to download (set: " << setName << " card: " << correctedCardname << ")";
+        cardsToDownload.append(pic);
+        startPicDownloads();
+    } else if (pic.nextSet()) {
+        qDebug() << "Picture NOT found and download disabled, moving to next set (newset: " << pic.getSetName() << " card: " << correctedCardname << ")";
+        mutex.lock();
+        loadQueue.prepend(pic);
+        mutex.unlock();
+        emit startLoadQueue();
+    } else {
+        qDebug() << "Picture NOT found, download disabled, no more sets to try: BAILING OUT (oldset: " << setName << " card: " << correctedCardname << ")";
+        finishLoading(pic.getCard(), QList<QImage>());
     }
 }
 
-QString PictureLoader::getPicUrl()
+void PictureLoader::finishLoading(CardInfo *card, const QList<QImage> &levels)
+{
+    mutex.lock();
+    cardsLoading.remove(card);
+    mutex.unlock();
+
+    emit imageLoaded(card, levels);
+}
+
+QString PictureLoader::getPicUrl(const PictureToLoad &pic) const
 {
     if (!picDownload) return QString("");
 
-    CardInfo *card = cardBeingDownloaded.getCard();
-    CardSet *set=cardBeingDownloaded.getCurrentSet();
+    CardInfo *card = pic.getCard();
+    CardSet *set = pic.getCurrentSet();
     QString picUrl = QString("");
 
     // if sets have been defined for the card, they can contain custom picUrls
@@ -368,116 +577,126 @@ QString PictureLoader::getPicUrl()
     return picUrl;
 }
 
-void PictureLoader::startNextPicDownload()
+void PictureLoader::startPicDownloads()
 {
-    if (cardsToDownload.isEmpty()) {
-        cardBeingDownloaded = 0;
-        downloadRunning = false;
-        return;
-    }
-
-    downloadRunning = true;
-
-    cardBeingDownloaded = cardsToDownload.takeFirst();
+    // Downloads are started in queue order, skipping those for hosts
+    // that already have the maximum number of downloads running.
+    int i = 0;
+    while (i < cardsToDownload.size()) {
+        QString picUrl = getPicUrl(cardsToDownload[i]);
+        if (picUrl.isEmpty()) {
+            picDownloadFailed(cardsToDownload.takeAt(i));
+            continue;
+        }
 
-    QString picUrl = getPicUrl();
-    if (picUrl.isEmpty()) {
-        downloadRunning = false;
-        picDownloadFailed();
-    } else {
         QUrl url(picUrl);
+        int &hostDownloads = downloadsPerHost[url.host()];
+        if (hostDownloads >= maxDownloadsPerHost) {
+            ++i;
+            continue;
+        }
+        ++hostDownloads;
 
+        PictureToLoad pic = cardsToDownload.takeAt(i);
         QNetworkRequest req(url);
-        qDebug() << "starting picture download:" << cardBeingDownloaded.getCard()->getName() << "Url:" << req.url();
-        networkManager->get(req);
+        qDebug() << "starting picture download:" << pic.getCard()->getName() << "Url:" << req.url();
+        cardsBeingDownloaded.insert(networkManager->get(req), pic);
     }
 }
 
-void PictureLoader::picDownloadFailed()
+void PictureLoader::picDownloadFailed(PictureToLoad pic)
 {
-    if (cardBeingDownloaded.nextSet())
+    if (pic.nextSet())
     {
-        qDebug() << "Picture NOT found, download failed, moving to next set (newset: " << cardBeingDownloaded.getSetName() << " card: " << cardBeingDownloaded.getCard()->getCorrectedName() << ")";
+        qDebug() << "Picture NOT found, download failed, moving to next set (newset: " << pic.getSetName() << " card: " << pic.getCard()->getCorrectedName() << ")";
         mutex.lock();
-        loadQueue.prepend(cardBeingDownloaded);
+        loadQueue.prepend(pic);
         mutex.unlock();
         emit startLoadQueue();
     } else {
-        qDebug() << "Picture NOT found, download failed, no more sets to try: BAILING OUT (oldset: " << cardBeingDownloaded.getSetName() << " card: " << cardBeingDownloaded.getCard()->getCorrectedName() << ")";
-        cardBeingDownloaded = 0;
-        emit imageLoaded(cardBeingDownloaded.getCard(), QImage());
+        qDebug() << "Picture NOT found, download failed, no more sets to try: BAILING OUT (oldset: " << pic.getSetName() << " card: " << pic.getCard()->getCorrectedName() << ")";
+        finishLoading(pic.getCard(), QList<QImage>());
     }
 }
 
 void PictureLoader::picDownloadFinished(QNetworkReply *reply)
 {
-    QString picsPath = _picsPath;
+    reply->deleteLater();
+    PictureToLoad pic = cardsBeingDownloaded.take(reply);
+
+    const QString host = reply->request().url().host();
+    if (--downloadsPerHost[host] <= 0)
+        downloadsPerHost.remove(host);
+
     if (reply->error()) {
         qDebug() << "Download failed:" << reply->errorString();
     }
 
-    const QByteArray &picData = reply->peek(reply->size()); //peek is used to keep the data in the buffer for use by QImageReader
+    const QByteArray picData = reply->readAll();
 
     // check if the image is blacklisted
     QString md5sum = QCryptographicHash::hash(picData, QCryptographicHash::Md5).toHex();
     if(md5Blacklist.contains(md5sum))
     {
         qDebug() << "Picture downloaded, but blacklisted (" << md5sum << "), will consider it as not found";
-        picDownloadFailed();
-        reply->deleteLater();
-        startNextPicDownload();
-        return;
+        picDownloadFailed(pic);
+    } else {
+        QString saveDir;
+        if (!pic.getSetName().isEmpty()) {
+            QMutexLocker locker(&mutex);
+            saveDir = _picsPath + "/downloadedPics/" + pic.getSetName();
+        }
+
+        cardsBeingDecoded.insert(pic.getCard(), pic);
+        decoderPool.start(new PictureDecoder(this, &thumbnailCache, pic.getCard(), picData, saveDir, pic.getCard()->getCorrectedName()));
     }
 
-    QImage testImage;
-    
-    QImageReader imgReader;
-    imgReader.setDecideFormatFromContent(true);
-    imgReader.setDevice(reply);
-    QString extension = "." + imgReader.format(); //the format is determined prior to reading the QImageReader data into a QImage object, as that wipes the QImageReader buffer
-    if (extension == ".jpeg")
-        extension = ".jpg";
-    
-    if (imgReader.read(&testImage)) {
-        QString setName = cardBeingDownloaded.getSetName();
-        if(!setName.isEmpty())
-        {
-            if (!QDir().mkpath(picsPath + "/downloadedPics/" + setName)) {
-                qDebug() << picsPath + "/downloadedPics/" + setName + " could not be created.";
-                return;
-            }
+    startPicDownloads();
+}
 
-            QFile newPic(picsPath + "/downloadedPics/" + setName + "/" + cardBeingDownloaded.getCard()->getCorrectedName() + extension);
-            if (!newPic.open(QIODevice::WriteOnly))
-                return;
-            newPic.write(picData);
-            newPic.close();
-        }
+void PictureLoader::pictureDecoded(CardInfo *card, const QList<QImage> &levels, bool downloaded, const QString &savedFileName)
+{
+    PictureToLoad pic = cardsBeingDecoded.take(card);
 
-        emit imageLoaded(cardBeingDownloaded.getCard(), testImage);
-    } else {
-        picDownloadFailed();
-    } 
+    if (!savedFileName.isEmpty() && savedFileName.startsWith(indexedPicsPath + "/"))
+        addPictureFile(savedFileName.mid(indexedPicsPath.size() + 1), savedFileName);
 
-    reply->deleteLater();
-    startNextPicDownload();
+    if (!levels.isEmpty())
+        finishLoading(card, levels);
+    else if (downloaded)
+        picDownloadFailed(pic);
+    else
+        pictureNotFound(pic);
 }
 
-void PictureLoader::loadImage(CardInfo *card)
+void PictureLoader::thumbnailDecoded(CardInfo *card, const QList<QImage> &thumbnails)
+{
+    // only if the picture itself has not been decoded first
+    if (cardsBeingDecoded.contains(card))
+        emit imageLoaded(card, thumbnails);
+}
+
+void PictureLoader::loadImage(CardInfo *card, Priority priority)
 {
     QMutexLocker locker(&mutex);
 
     // avoid queueing the same card more than once
-    if(card == cardBeingLoaded.getCard() || card == cardBeingDownloaded.getCard())
+    if (cardsLoading.contains(card)) {
+        // a prefetched card that is now needed on screen moves up
+        if (priority == VisiblePriority)
+            for (int i = 0; i < prefetchQueue.size(); ++i)
+                if (prefetchQueue[i].getCard() == card) {
+                    loadQueue.append(prefetchQueue.takeAt(i));
+                    break;
+                }
         return;
-
-    foreach(PictureToLoad pic, loadQueue)
-    {
-        if(pic.getCard() == card)
-            return;
     }
 
-    loadQueue.append(PictureToLoad(card));
+    cardsLoading.insert(card);
+    if (priority == VisiblePriority)
+        loadQueue.append(PictureToLoad(card));
+    else
+        prefetchQueue.append(PictureToLoad(card));
     emit startLoadQueue();
 }
 
@@ -522,23 +741,36 @@ CardInfo::CardInfo(CardDatabase *_db,
       name(_name),
       isToken(_isToken),
       sets(_sets),
-      manacost(_manacost),
-      cmc(_cmc),
-      cardtype(_cardtype),
-      powtough(_powtough),
+      manacost(_db->intern(_manacost)),
+      cmc(_db->intern(_cmc)),
+      cardtype(_db->intern(_cardtype)),
+      powtough(_db->intern(_powtough)),
       text(_text),
-      colors(_colors),
+      colors(_db->intern(_colors)),
       relatedCards(_relatedCards),
       upsideDownArt(_upsideDownArt),
       loyalty(_loyalty),
-      customPicURLs(_customPicURLs),
-      customPicURLsHq(_customPicURLsHq),
-      muIds(_muIds),
       cipt(_cipt),
       tableRow(_tableRow)
 {
-    pixmapCacheKey = QLatin1String("card_") + name;
-    simpleName = CardInfo::simplifyName(name);
+    pixmapCacheId = db->newPixmapCacheId();
+
+    QMapIterator<QString, int> muIdIterator(_muIds);
+    while (muIdIterator.hasNext()) {
+        muIdIterator.next();
+        getSetInfo(muIdIterator.key()).muId = muIdIterator.value();
+    }
+    QMapIterator<QString, QString> picURLIterator(_customPicURLs);
+    while (picURLIterator.hasNext()) {
+        picURLIterator.next();
+        getSetInfo(picURLIterator.key()).customPicURL = picURLIterator.value();
+    }
+    QMapIterator<QString, QString> picURLHqIterator(_customPicURLsHq);
+    while (picURLHqIterator.hasNext()) {
+        picURLHqIterator.next();
+        getSetInfo(picURLHqIterator.key()).customPicURLHq = picURLHqIterator.value();
+    }
+    perSetInfo.squeeze();
 
     for (int i = 0; i < sets.size(); i++)
         sets[i]->append(this);
@@ -549,6 +781,83 @@ CardInfo::~CardInfo()
     clearPixmapCache();
 }
 
+const CardInfoPerSet *CardInfo::findSetInfo(const QString &set) const
+{
+    for (int i = 0; i < perSetInfo.size(); ++i)
+        if (perSetInfo[i].setName == set)
+            return &perSetInfo[i];
+    return 0;
+}
+
+CardInfoPerSet &CardInfo::getSetInfo(const QString &set)
+{
+    for (int i = 0; i < perSetInfo.size(); ++i)
+        if (perSetInfo[i].setName == set)
+            return perSetInfo[i];
+    perSetInfo.append(CardInfoPerSet(db->intern(set)));
+    return perSetInfo.last();
+}
+
+QString CardInfo::getCustomPicURL(const QString &set) const
+{
+    const CardInfoPerSet *setInfo = findSetInfo(set);
+    return setInfo ? setInfo->customPicURL : QString();
+}
+
+QString CardInfo::getCustomPicURLHq(const QString &set) const
+{
+    const CardInfoPerSet *setInfo = findSetInfo(set);
+    return setInfo ? setInfo->customPicURLHq : QString();
+}
+
+int CardInfo::getMuId(const QString &set) const
+{
+    const CardInfoPerSet *setInfo = findSetInfo(set);
+    return setInfo ? setInfo->muId : 0;
+}
+
+void CardInfo::setManaCost(const QString &_manaCost)
+{
+    manacost = db->intern(_manaCost);
+    db->notifyCardInfoChanged(this);
+}
+
+void CardInfo::setCmc(const QString &_cmc)
+{
+    cmc = db->intern(_cmc);
+    db->notifyCardInfoChanged(this);
+}
+
+void CardInfo::setCardType(const QString &_cardType)
+{
+    cardtype = db->intern(_cardType);
+    db->notifyCardInfoChanged(this);
+}
+
+void CardInfo::setPowTough(const QString &_powTough)
+{
+    powtough = db->intern(_powTough);
+    db->notifyCardInfoChanged(this);
+}
+
+void CardInfo::setText(const QString &_text)
+{
+    text = _text;
+    db->notifyCardInfoChanged(this);
+}
+
+void CardInfo::setColors(const QStringList &_colors)
+{
+    colors = db->intern(_colors);
+    db->notifyCardInfoChanged(this);
+}
+
+void CardInfo::setLoyalty(int _loyalty)
+{
+    loyalty = _loyalty;
+    db->notifyCardInfoChanged(this);
+}
+
 QString CardInfo::getMainCardType() const
 {
     QString result = getCardType();
@@ -593,74 +902,65 @@ void CardInfo::addToSet(CardSet *set)
     sets << set;
 }
 
-void CardInfo::loadPixmap(QPixmap &pixmap)
+void CardInfo::loadPixmap(QPixmap &pixmap, PictureLoader::Priority priority)
 {
-    if(QPixmapCache::find(pixmapCacheKey, &pixmap))
+    CardPixmapCache &pixmapCache = db->getPixmapCache();
+    if(pixmapCache.findFull(pixmapCacheId, pixmap))
         return;
 
     pixmap = QPixmap();
 
     if (getName().isEmpty()) {
-        pixmap.load(settingsCache->getCardBackPicturePath());
+        QImage image(settingsCache->getCardBackPicturePath());
+        if (image.isNull()) {
+            QSvgRenderer svg(QString(":/back.svg"));
+            image = QImage(svg.defaultSize(), QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::transparent);
+            QPainter painter(&image);
+            svg.render(&painter);
+        }
+        pixmapCache.insert(pixmapCacheId, CardPixmapCache::createLevels(image));
+        pixmap = QPixmap::fromImage(image);
         return;
     }
 
-    db->loadImage(this);
+    db->loadImage(this, priority);
 }
 
-void CardInfo::imageLoaded(const QImage &image)
+void CardInfo::imageLoaded(const QList<QImage> &levels)
 {
-    if (!image.isNull()) {
-        if(upsideDownArt)
-        {
-            QImage mirrorImage = image.mirrored(true, true);
-            QPixmapCache::insert(pixmapCacheKey, QPixmap::fromImage(mirrorImage));
-        } else {
-            QPixmapCache::insert(pixmapCacheKey, QPixmap::fromImage(image));
-        }
+    if (!levels.isEmpty()) {
+        CardPixmapCache &pixmapCache = db->getPixmapCache();
+        // replaces the thumbnails shown while the picture was being decoded
+        if (pixmapCache.contains(pixmapCacheId))
+            pixmapCache.remove(pixmapCacheId);
+        pixmapCache.insert(pixmapCacheId, levels);
         emit pixmapUpdated();
     }
 }
 
 void CardInfo::getPixmap(QSize size, QPixmap &pixmap)
 {
-    QString key = QLatin1String("card_") + name + QLatin1Char('_') + QString::number(size.width()) + QString::number(size.height());
-    if(QPixmapCache::find(key, &pixmap))
+    CardPixmapCache &pixmapCache = db->getPixmapCache();
+    if(pixmapCache.find(pixmapCacheId, size, pixmap))
         return;
 
     QPixmap bigPixmap;
     loadPixmap(bigPixmap);
     if (bigPixmap.isNull()) {
-        if (!getName().isEmpty()) {
-            pixmap = QPixmap(); // null
-            return;
-        } else {
-            QSvgRenderer svg(QString(":/back.svg"));
-            bigPixmap = QPixmap(svg.defaultSize());
-            bigPixmap.fill(Qt::transparent);
-            QPainter painter(&bigPixmap);
-            svg.render(&painter);
-        }
+        pixmap = QPixmap(); // null
+        return;
     }
 
-    pixmap = bigPixmap.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    QPixmapCache::insert(key, pixmap);
+    // the card back, which loadPixmap() has just added to the cache
+    if (!pixmapCache.find(pixmapCacheId, size, pixmap))
+        pixmap = bigPixmap.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
 }
 
 void CardInfo::clearPixmapCache()
 {
     //qDebug() << "Deleting pixmap for" << name;
-    QPixmapCache::remove(pixmapCacheKey);
-}
-
-void CardInfo::clearPixmapCacheMiss()
-{
-    QPixmap pixmap;
-    if(!QPixmapCache::find(pixmapCacheKey, &pixmap))
-        return;
-
-    if (pixmap.isNull())
-        clearPixmapCache();
+    db->getPixmapCache().remove(pixmapCacheId);
 }
 
 void CardInfo::updatePixmapCache()
@@ -747,13 +1047,27 @@ static QXmlStreamWriter &operator<<(QXmlStreamWriter &xml, const CardInfo *info)
 }
 
 CardDatabase::CardDatabase(QObject *parent)
-    : QObject(parent), noCard(0), loadStatus(NotLoaded)
+    : QObject(parent), noCard(0), lastPixmapCacheId(0), loadStatus(NotLoaded), cardDatabaseLoadId(0), tokenDatabaseLoadId(0), lastLoadId(0)
 {
+    qRegisterMetaType<SetDataList>("SetDataList");
+    qRegisterMetaType<CardDataList>("CardDataList");
+    qRegisterMetaType<LoadStatus>("LoadStatus");
+
     connect(settingsCache, SIGNAL(picsPathChanged()), this, SLOT(picsPathChanged()));
     connect(settingsCache, SIGNAL(cardDatabasePathChanged()), this, SLOT(loadCardDatabase()));
     connect(settingsCache, SIGNAL(tokenDatabasePathChanged()), this, SLOT(loadTokenDatabase()));
     connect(settingsCache, SIGNAL(picDownloadChanged()), this, SLOT(picDownloadChanged()));
     connect(settingsCache, SIGNAL(picDownloadHqChanged()), this, SLOT(picDownloadHqChanged()));
+    connect(settingsCache, SIGNAL(pixmapCacheSizeChanged(int)), this, SLOT(pixmapCacheSizeChanged(int)));
+    pixmapCacheSizeChanged(settingsCache->getPixmapCacheSize());
+
+    loaderThread = new QThread;
+    loader = new CardDatabaseLoader;
+    loader->moveToThread(loaderThread);
+    connect(loader, SIGNAL(setsLoaded(int, const SetDataList &)), this, SLOT(setsLoaded(int, const SetDataList &)));
+    connect(loader, SIGNAL(cardsLoaded(int, const CardDataList &)), this, SLOT(cardsLoaded(int, const CardDataList &)));
+    connect(loader, SIGNAL(loadFinished(int, LoadStatus)), this, SLOT(loadFinished(int, LoadStatus)));
+    loaderThread->start();
 
     loadCardDatabase();
     loadTokenDatabase();
@@ -761,7 +1075,7 @@ CardDatabase::CardDatabase(QObject *parent)
     pictureLoaderThread = new QThread;
     pictureLoader = new PictureLoader(settingsCache->getPicsPath(), settingsCache->getPicDownload(), settingsCache->getPicDownloadHq());
     pictureLoader->moveToThread(pictureLoaderThread);
-    connect(pictureLoader, SIGNAL(imageLoaded(CardInfo *, const QImage &)), this, SLOT(imageLoaded(CardInfo *, const QImage &)));
+    connect(pictureLoader, SIGNAL(imageLoaded(CardInfo *, const QList<QImage> &)), this, SLOT(imageLoaded(CardInfo *, const QList<QImage> &)));
     pictureLoaderThread->start(QThread::LowPriority);
 
     noCard = new CardInfo(this);
@@ -772,6 +1086,10 @@ CardDatabase::CardDatabase(QObject *parent)
 
 CardDatabase::~CardDatabase()
 {
+    loader->deleteLater();
+    loaderThread->wait();
+    delete loaderThread;
+
     clear();
     delete noCard;
     
@@ -799,6 +1117,38 @@ void CardDatabase::clear()
     // The pointers themselves were already deleted, so we don't delete them
     // again.
     simpleNameCards.clear();
+
+    stringPool.clear();
+    stringListPool.clear();
+}
+
+QString CardDatabase::intern(const QString &string)
+{
+    if (string.isEmpty())
+        return QString();
+
+    QSet<QString>::const_iterator pooled = stringPool.constFind(string);
+    if (pooled != stringPool.constEnd())
+        return *pooled;
+    stringPool.insert(string);
+    return string;
+}
+
+QStringList CardDatabase::intern(const QStringList &list)
+{
+    if (list.isEmpty())
+        return QStringList();
+
+    const QString key = list.join("|");
+    QHash<QString, QStringList>::const_iterator pooled = stringListPool.constFind(key);
+    if (pooled != stringListPool.constEnd())
+        return pooled.value();
+
+    QStringList result;
+    for (int i = 0; i < list.size(); ++i)
+        result.append(intern(list[i]));
+    stringListPool.insert(key, result);
+    return result;
 }
 
 void CardDatabase::addCard(CardInfo *card)
@@ -848,111 +1198,7 @@ SetList CardDatabase::getSetList() const
 
 void CardDatabase::clearPixmapCache()
 {
-    // This also clears the cards in simpleNameCards since they point to the
-    // same object.
-    QHashIterator<QString, CardInfo *> i(cards);
-    while (i.hasNext()) {
-        i.next();
-        i.value()->clearPixmapCache();
-    }
-    if (noCard)
-        noCard->clearPixmapCache();
-}
-
-void CardDatabase::loadSetsFromXml(QXmlStreamReader &xml)
-{
-    while (!xml.atEnd()) {
-        if (xml.readNext() == QXmlStreamReader::EndElement)
-            break;
-        if (xml.name() == "set") {
-            QString shortName, longName, setType;
-            QDate releaseDate;
-            while (!xml.atEnd()) {
-                if (xml.readNext() == QXmlStreamReader::EndElement)
-                    break;
-                if (xml.name() == "name")
-                    shortName = xml.readElementText();
-                else if (xml.name() == "longname")
-                    longName = xml.readElementText();
-                else if (xml.name() == "settype")
-                    setType = xml.readElementText();
-                else if (xml.name() == "releasedate")
-                    releaseDate = QDate::fromString(xml.readElementText(), Qt::ISODate);
-            }
-
-            CardSet * newSet = getSet(shortName);
-            newSet->setLongName(longName);
-            newSet->setSetType(setType);
-            newSet->setReleaseDate(releaseDate);
-        }
-    }
-}
-
-void CardDatabase::loadCardsFromXml(QXmlStreamReader &xml, bool tokens)
-{
-    while (!xml.atEnd()) {
-        if (xml.readNext() == QXmlStreamReader::EndElement)
-            break;
-        if (xml.name() == "card") {
-            QString name, manacost, cmc, type, pt, text;
-            QStringList colors, relatedCards;
-            QStringMap customPicURLs, customPicURLsHq;
-            MuidMap muids;
-            SetList sets;
-            int tableRow = 0;
-            int loyalty = 0;
-            bool cipt = false;
-            bool isToken = false;
-            bool upsideDown = false;
-            while (!xml.atEnd()) {
-                if (xml.readNext() == QXmlStreamReader::EndElement)
-                    break;
-                if (xml.name() == "name")
-                    name = xml.readElementText();
-                else if (xml.name() == "manacost")
-                    manacost = xml.readElementText();
-                else if (xml.name() == "cmc")
-                    cmc = xml.readElementText();
-                else if (xml.name() == "type")
-                    type = xml.readElementText();
-                else if (xml.name() == "pt")
-                    pt = xml.readElementText();
-                else if (xml.name() == "text")
-                    text = xml.readElementText();
-                else if (xml.name() == "set") {
-                    QXmlStreamAttributes attrs = xml.attributes();
-                    QString setName = xml.readElementText();
-                    sets.append(getSet(setName));
-                    if (attrs.hasAttribute("muId")) {
-                        muids[setName] = attrs.value("muId").toString().toInt();
-                    }
-                    if (attrs.hasAttribute("picURL")) {
-                        customPicURLs[setName] = attrs.value("picURL").toString();
-                    }
-                    if (attrs.hasAttribute("picURLHq")) {
-                        customPicURLsHq[setName] = attrs.value("picURLHq").toString();
-                    }
-                } else if (xml.name() == "color")
-                    colors << xml.readElementText();
-                else if (xml.name() == "related")
-                    relatedCards << xml.readElementText();
-                else if (xml.name() == "tablerow")
-                    tableRow = xml.readElementText().toInt();
-                else if (xml.name() == "cipt")
-                    cipt = (xml.readElementText() == "1");
-                else if (xml.name() == "upsidedown")
-                    upsideDown = (xml.readElementText() == "1");
-                else if (xml.name() == "loyalty")
-                    loyalty = xml.readElementText().toInt();
-                else if (xml.name() == "token")
-                    isToken = xml.readElementText().toInt();
-            }
-
-            if (isToken == tokens) {
-                addCard(new CardInfo(this, name, isToken, manacost, cmc, type, pt, text, colors, relatedCards, upsideDown, loyalty, cipt, tableRow, sets, customPicURLs, customPicURLsHq, muids));
-            }
-        }
-    }
+    pixmapCache.clear();
 }
 
 CardInfo *CardDatabase::getCardFromMap(CardNameMap &cardMap, const QString &cardName, bool createIfNotFound) {
@@ -969,33 +1215,44 @@ CardInfo *CardDatabase::getCardFromMap(CardNameMap &cardMap, const QString &card
         return 0;
 }
 
-LoadStatus CardDatabase::loadFromFile(const QString &fileName, bool tokens)
+void CardDatabase::addSets(const SetDataList &loadedSets)
 {
-    QFile file(fileName);
-    file.open(QIODevice::ReadOnly);
-    if (!file.isOpen())
-        return FileError;
-
-    QXmlStreamReader xml(&file);
-    while (!xml.atEnd()) {
-        if (xml.readNext() == QXmlStreamReader::StartElement) {
-            if (xml.name() != "cockatrice_carddatabase")
-                return Invalid;
-            int version = xml.attributes().value("version").toString().toInt();
-            if (version < versionNeeded) {
-                qDebug() << "loadFromFile(): Version too old: " << version;
-                return VersionTooOld;
-            }
-            while (!xml.atEnd()) {
-                if (xml.readNext() == QXmlStreamReader::EndElement)
-                    break;
-                if (xml.name() == "sets")
-                    loadSetsFromXml(xml);
-                else if (xml.name() == "cards")
-                    loadCardsFromXml(xml, tokens);
-            }
+    for (int i = 0; i < loadedSets.size(); ++i) {
+        const SetData &setData = loadedSets[i];
+        QString longName = setData.longName, setType = setData.setType;
+        QDate releaseDate = setData.releaseDate;
+
+        CardSet * newSet = getSet(setData.shortName);
+        newSet->setLongName(longName);
+        newSet->setSetType(setType);
+        newSet->setReleaseDate(releaseDate);
+    }
+}
+
+void CardDatabase::addCards(const CardDataList &loadedCards, bool tokens)
+{
+    for (int i = 0; i < loadedCards.size(); ++i) {
+        const CardData &card = loadedCards[i];
+        SetList cardSets;
+        for (int j = 0; j < card.sets.size(); ++j)
+            cardSets.append(getSet(card.sets[j]));
+
+        if (card.isToken == tokens) {
+            addCard(new CardInfo(this, card.name, card.isToken, card.manacost, card.cmc, card.cardtype, card.powtough, card.text, card.colors, card.relatedCards, card.upsideDownArt, card.loyalty, card.cipt, card.tableRow, cardSets, card.customPicURLs, card.customPicURLsHq, card.muIds));
         }
     }
+}
+
+LoadStatus CardDatabase::loadFromFile(const QString &fileName, bool tokens)
+{
+    SetDataList loadedSets;
+    CardDataList loadedCards;
+    LoadStatus status = CardDatabaseLoader::load(fileName, loadedSets, loadedCards);
+    addSets(loadedSets);
+    addCards(loadedCards, tokens);
+    if (status != Ok)
+        return status;
+
     qDebug() << cards.size() << "cards in" << sets.size() << "sets loaded";
 
     if (cards.isEmpty()) return NoCards;
@@ -1013,7 +1270,7 @@ bool CardDatabase::saveToFile(const QString &fileName, bool tokens)
     xml.setAutoFormatting(true);
     xml.writeStartDocument();
     xml.writeStartElement("cockatrice_carddatabase");
-    xml.writeAttribute("version", QString::number(versionNeeded));
+    xml.writeAttribute("version", QString::number(CardDatabaseLoader::versionNeeded));
 
     if (!tokens) {
         xml.writeStartElement("sets");
@@ -1042,21 +1299,11 @@ bool CardDatabase::saveToFile(const QString &fileName, bool tokens)
 void CardDatabase::picDownloadChanged()
 {
     pictureLoader->setPicDownload(settingsCache->getPicDownload());
-    if (settingsCache->getPicDownload()) {
-        QHashIterator<QString, CardInfo *> cardIterator(cards);
-        while (cardIterator.hasNext())
-            cardIterator.next().value()->clearPixmapCacheMiss();
-    }
 }
 
 void CardDatabase::picDownloadHqChanged()
 {
     pictureLoader->setPicDownloadHq(settingsCache->getPicDownloadHq());
-    if (settingsCache->getPicDownloadHq()) {
-        QHashIterator<QString, CardInfo *> cardIterator(cards);
-        while (cardIterator.hasNext())
-            cardIterator.next().value()->clearPixmapCacheMiss();
-    }
 }
 
 void CardDatabase::emitCardListChanged()
@@ -1070,7 +1317,12 @@ LoadStatus CardDatabase::loadCardDatabase(const QString &path, bool tokens)
     if (!path.isEmpty())
         tempLoadStatus = loadFromFile(path, tokens);
 
-    if (tempLoadStatus == Ok) {
+    return finishLoad(path, tokens, tempLoadStatus);
+}
+
+LoadStatus CardDatabase::finishLoad(const QString &path, bool tokens, LoadStatus status)
+{
+    if (status == Ok) {
         SetList allSets;
         QHashIterator<QString, CardSet *> setsIterator(sets);
         while (setsIterator.hasNext())
@@ -1083,22 +1335,74 @@ LoadStatus CardDatabase::loadCardDatabase(const QString &path, bool tokens)
     }
 
     if (!tokens) {
-        loadStatus = tempLoadStatus;
+        loadStatus = status;
         qDebug() << "loadCardDatabase(): Path = " << path << " Status = " << loadStatus;
     }
 
+    return status;
+}
+
+void CardDatabase::startLoad(const QString &path, bool tokens)
+{
+    const int loadId = ++lastLoadId;
+    if (tokens)
+        tokenDatabaseLoadId = loadId;
+    else
+        cardDatabaseLoadId = loadId;
+    QMetaObject::invokeMethod(loader, "loadFile", Qt::QueuedConnection, Q_ARG(int, loadId), Q_ARG(QString, path));
+}
 
-    return tempLoadStatus;
+void CardDatabase::setsLoaded(int loadId, const SetDataList &loadedSets)
+{
+    if ((loadId == cardDatabaseLoadId) || (loadId == tokenDatabaseLoadId))
+        addSets(loadedSets);
+}
+
+void CardDatabase::cardsLoaded(int loadId, const CardDataList &loadedCards)
+{
+    if ((loadId == cardDatabaseLoadId) || (loadId == tokenDatabaseLoadId))
+        addCards(loadedCards, loadId == tokenDatabaseLoadId);
+}
+
+void CardDatabase::loadFinished(int loadId, LoadStatus status)
+{
+    // Results of a load that was superseded by a newer one of the same kind are dropped.
+    QString path;
+    bool tokens;
+    if (loadId == cardDatabaseLoadId) {
+        cardDatabaseLoadId = 0;
+        path = settingsCache->getCardDatabasePath();
+        tokens = false;
+    } else if (loadId == tokenDatabaseLoadId) {
+        tokenDatabaseLoadId = 0;
+        path = settingsCache->getTokenDatabasePath();
+        tokens = true;
+    } else
+        return;
+
+    if ((status == Ok) && cards.isEmpty())
+        status = NoCards;
+    finishLoad(path, tokens, status);
+
+    emit databaseLoaded();
+}
+
+void CardDatabase::waitUntilLoaded()
+{
+    QEventLoop eventLoop;
+    connect(this, SIGNAL(databaseLoaded()), &eventLoop, SLOT(quit()));
+    while (isLoading())
+        eventLoop.exec();
 }
 
 void CardDatabase::loadCardDatabase()
 {
-    loadCardDatabase(settingsCache->getCardDatabasePath(), false);
+    startLoad(settingsCache->getCardDatabasePath(), false);
 }
 
 void CardDatabase::loadTokenDatabase()
 {
-    loadCardDatabase(settingsCache->getTokenDatabasePath(), true);
+    startLoad(settingsCache->getTokenDatabasePath(), true);
 }
 
 void CardDatabase::loadCustomCardDatabases(const QString &path)
@@ -1143,17 +1447,17 @@ void CardDatabase::cacheCardPixmaps(const QStringList &cardNames)
     // never cache more than 300 cards at once for a single deck
     int max = qMin(cardNames.size(), 300);
     for (int i = 0; i < max; ++i)
-        getCard(cardNames[i])->loadPixmap(tmp);
+        getCard(cardNames[i])->loadPixmap(tmp, PictureLoader::PrefetchPriority);
 }
 
-void CardDatabase::loadImage(CardInfo *card)
+void CardDatabase::loadImage(CardInfo *card, PictureLoader::Priority priority)
 {
-    pictureLoader->loadImage(card);
+    pictureLoader->loadImage(card, priority);
 }
 
-void CardDatabase::imageLoaded(CardInfo *card, QImage image)
+void CardDatabase::imageLoaded(CardInfo *card, const QList<QImage> &levels)
 {
-    card->imageLoaded(image);
+    card->imageLoaded(levels);
 }
 
 void CardDatabase::picsPathChanged()
@@ -1162,6 +1466,11 @@ void CardDatabase::picsPathChanged()
     clearPixmapCache();
 }
 
+void CardDatabase::pixmapCacheSizeChanged(int newSizeInMBs)
+{
+    pixmapCache.setMaxSize(newSizeInMBs);
+}
+
 void CardDatabase::checkUnknownSets()
 {
     SetList sets = getSetList();
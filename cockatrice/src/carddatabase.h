@@ -2,6 +2,8 @@
 #define CARDDATABASE_H
 
 #include <QHash>
+#include <QSet>
+#include <QVector>
 #include <QPixmap>
 #include <QMap>
 #include <QDate>
@@ -12,7 +14,11 @@
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QThreadPool>
 #include <QPixmapCache>
+#include "carddatabaseloader.h"
+#include "cardpixmapcache.h"
+#include "thumbnailcache.h"
 
 class CardDatabase;
 class CardInfo;
@@ -20,11 +26,6 @@ class QNetworkAccessManager;
 class QNetworkReply;
 class QNetworkRequest;
 
-typedef QMap<QString, QString> QStringMap;
-
-// If we don't typedef this, CardInfo::CardInfo will refuse to compile on OS X < 10.9
-typedef QMap<QString, int> MuidMap;
-
 class CardSet : public QList<CardInfo *> {
 private:
     QString shortName, longName;
@@ -81,19 +82,55 @@ public:
     void setHq(bool _hq) { hq = _hq; }
 };
 
+/*
+ * Finds, downloads and decodes card pictures on a thread of its own.
+ *
+ * Cards needed on screen are served before prefetched ones. Picture files
+ * are looked up in an index of the pictures folder, built once per folder
+ * instead of probing the disk for every card and set. Decoding runs on a
+ * thread pool, and several downloads per host are in flight at once.
+ * Pictures with thumbnails in the ThumbnailCache have those shown first.
+ */
 class PictureLoader : public QObject {
     Q_OBJECT
+public:
+    enum Priority { VisiblePriority, PrefetchPriority };
 private:
+    static const int maxDownloadsPerHost;
+
     QString _picsPath;
-    QList<PictureToLoad> loadQueue;
+    QList<PictureToLoad> loadQueue, prefetchQueue;
+    // the cards which are queued or being loaded
+    QSet<CardInfo *> cardsLoading;
     QMutex mutex;
+
+    // Picture files by their path relative to the pictures folder,
+    // with and without extension. Only used by the loader thread.
+    // Where file names are case-insensitive, the paths are lower-cased.
+    QHash<QString, QString> pictureFiles;
+    QString indexedPicsPath;
+    // the file name suffixes of the supported image formats
+    QStringList pictureFileSuffixes;
+
+    ThumbnailCache thumbnailCache;
+    QThreadPool decoderPool;
+    QHash<CardInfo *, PictureToLoad> cardsBeingDecoded;
     QNetworkAccessManager *networkManager;
     QList<PictureToLoad> cardsToDownload;
-    PictureToLoad cardBeingLoaded;
-    PictureToLoad cardBeingDownloaded;
-    bool picDownload, picDownloadHq, downloadRunning, loadQueueRunning;
-    void startNextPicDownload();
-    QString getPicUrl();
+    QHash<QNetworkReply *, PictureToLoad> cardsBeingDownloaded;
+    QHash<QString, int> downloadsPerHost;
+    bool picDownload, picDownloadHq, loadQueueRunning;
+
+    void indexPictureFiles(const QString &picsPath);
+    void addPictureFile(const QString &relativePath, const QString &filePath);
+    static QString pictureFileKey(const QString &relativePath);
+    QString probePictureFile(const QString &relativePath);
+    QString findPictureFile(const PictureToLoad &pic);
+    void pictureNotFound(PictureToLoad &pic);
+    void finishLoading(CardInfo *card, const QList<QImage> &levels);
+    void startPicDownloads();
+    void picDownloadFailed(PictureToLoad pic);
+    QString getPicUrl(const PictureToLoad &pic) const;
     static QStringList md5Blacklist;
 public:
     PictureLoader(const QString &__picsPath, bool _picDownload, bool _picDownloadHq, QObject *parent = 0);
@@ -101,17 +138,36 @@ public:
     void setPicsPath(const QString &path);
     void setPicDownload(bool _picDownload);
     void setPicDownloadHq(bool _picDownloadHq);
-    void loadImage(CardInfo *card);
+    void loadImage(CardInfo *card, Priority priority = VisiblePriority);
 private slots:
     void picDownloadFinished(QNetworkReply *reply);
-    void picDownloadFailed();
+    void pictureDecoded(CardInfo *card, const QList<QImage> &levels, bool downloaded, const QString &savedFileName);
+    void thumbnailDecoded(CardInfo *card, const QList<QImage> &thumbnails);
 public slots:
     void processLoadQueue();
 signals:
     void startLoadQueue();
-    void imageLoaded(CardInfo *card, const QImage &image);
+    // The levels of the card's picture for CardPixmapCache, none if it was not found.
+    void imageLoaded(CardInfo *card, const QList<QImage> &levels);
 };
 
+/*
+ * What a card has per set it was printed in. Cards usually have only a handful
+ * of sets, so a flat list is both smaller and faster than one map per attribute.
+ */
+class CardInfoPerSet {
+public:
+    QString setName;
+    int muId;
+    QString customPicURL, customPicURLHq;
+    CardInfoPerSet(const QString &_setName = QString()) : setName(_setName), muId(0) { }
+};
+
+/*
+ * Strings that repeat across many cards (types, mana costs, colors, set names)
+ * are interned by the database, so that all cards share a single copy.
+ * Changes to a card are announced by CardDatabase::cardInfoChanged().
+ */
 class CardInfo : public QObject {
     Q_OBJECT
 private:
@@ -119,12 +175,6 @@ private:
 
     QString name;
 
-    /*
-     * The name without punctuation or capitalization, for better card tag name
-     * recognition.
-     */
-    QString simpleName;
-
     bool isToken;
     SetList sets;
     QString manacost;
@@ -136,11 +186,13 @@ private:
     QStringList relatedCards;
     bool upsideDownArt;
     int loyalty;
-    QStringMap customPicURLs, customPicURLsHq;
-    MuidMap muIds;
+    QVector<CardInfoPerSet> perSetInfo;
     bool cipt;
     int tableRow;
-    QString pixmapCacheKey;
+    int pixmapCacheId;
+
+    const CardInfoPerSet *findSetInfo(const QString &set) const;
+    CardInfoPerSet &getSetInfo(const QString &set);
 public:
     CardInfo(CardDatabase *_db,
         const QString &_name = QString(),
@@ -163,7 +215,12 @@ public:
         );
     ~CardInfo();
     const QString &getName() const { return name; }
-    const QString &getSimpleName() const { return simpleName; }
+
+    /*
+     * The name without punctuation or capitalization, for better card tag name
+     * recognition.
+     */
+    QString getSimpleName() const { return simplifyName(name); }
     bool getIsToken() const { return isToken; }
     const SetList &getSets() const { return sets; }
     const QString &getManaCost() const { return manacost; }
@@ -173,32 +230,32 @@ public:
     const QString &getText() const { return text; }
     const int &getLoyalty() const { return loyalty; }
     bool getCipt() const { return cipt; }
-    void setManaCost(const QString &_manaCost) { manacost = _manaCost; emit cardInfoChanged(this); }
-    void setCmc(const QString &_cmc) { cmc = _cmc; emit cardInfoChanged(this); }
-    void setCardType(const QString &_cardType) { cardtype = _cardType; emit cardInfoChanged(this); }
-    void setPowTough(const QString &_powTough) { powtough = _powTough; emit cardInfoChanged(this); }
-    void setText(const QString &_text) { text = _text; emit cardInfoChanged(this); }
-    void setColors(const QStringList &_colors) { colors = _colors; emit cardInfoChanged(this); }
+    void setManaCost(const QString &_manaCost);
+    void setCmc(const QString &_cmc);
+    void setCardType(const QString &_cardType);
+    void setPowTough(const QString &_powTough);
+    void setText(const QString &_text);
+    void setColors(const QStringList &_colors);
     const QStringList &getColors() const { return colors; }
     const QStringList &getRelatedCards() const { return relatedCards; }
     bool getUpsideDownArt() const { return upsideDownArt; }
-    QString getCustomPicURL(const QString &set) const { return customPicURLs.value(set); }
-    QString getCustomPicURLHq(const QString &set) const { return customPicURLsHq.value(set); }
-    int getMuId(const QString &set) const { return muIds.value(set); }
+    QString getCustomPicURL(const QString &set) const;
+    QString getCustomPicURLHq(const QString &set) const;
+    int getMuId(const QString &set) const;
     QString getMainCardType() const;
     QString getCorrectedName() const;
     int getTableRow() const { return tableRow; }
     void setTableRow(int _tableRow) { tableRow = _tableRow; }
-    void setLoyalty(int _loyalty) { loyalty = _loyalty; emit cardInfoChanged(this); }
-    void setCustomPicURL(const QString &_set, const QString &_customPicURL) { customPicURLs.insert(_set, _customPicURL); }
-    void setCustomPicURLHq(const QString &_set, const QString &_customPicURL) { customPicURLsHq.insert(_set, _customPicURL); }
-    void setMuId(const QString &_set, const int &_muId) { muIds.insert(_set, _muId); }
+    void setLoyalty(int _loyalty);
+    void setCustomPicURL(const QString &_set, const QString &_customPicURL) { getSetInfo(_set).customPicURL = _customPicURL; }
+    void setCustomPicURLHq(const QString &_set, const QString &_customPicURL) { getSetInfo(_set).customPicURLHq = _customPicURL; }
+    void setMuId(const QString &_set, const int &_muId) { getSetInfo(_set).muId = _muId; }
     void addToSet(CardSet *set);
-    void loadPixmap(QPixmap &pixmap);
+    void loadPixmap(QPixmap &pixmap, PictureLoader::Priority priority = PictureLoader::VisiblePriority);
     void getPixmap(QSize size, QPixmap &pixmap);
+    int getPixmapCacheId() const { return pixmapCacheId; }
     void clearPixmapCache();
-    void clearPixmapCacheMiss();
-    void imageLoaded(const QImage &image);
+    void imageLoaded(const QList<QImage> &levels);
 
     /**
      * Simplify a name to have no punctuation and lowercase all letters, for
@@ -209,11 +266,8 @@ public slots:
     void updatePixmapCache();
 signals:
     void pixmapUpdated();
-    void cardInfoChanged(CardInfo *card);
 };
 
-enum LoadStatus { Ok, VersionTooOld, Invalid, NotLoaded, FileError, NoCards };
-
 typedef QHash<QString, CardInfo *> CardNameMap;
 typedef QHash<QString, CardSet *> SetNameMap;
 
@@ -237,14 +291,28 @@ protected:
 
     CardInfo *noCard;
 
+    /*
+     * Pools of the strings shared between cards, see CardInfo.
+     */
+    QSet<QString> stringPool;
+    QHash<QString, QStringList> stringListPool;
+
+    CardPixmapCache pixmapCache;
+    int lastPixmapCacheId;
+
     QThread *pictureLoaderThread;
     PictureLoader *pictureLoader;
+    QThread *loaderThread;
+    CardDatabaseLoader *loader;
     LoadStatus loadStatus;
     bool detectedFirstRun;
 private:
-    static const int versionNeeded;
-    void loadCardsFromXml(QXmlStreamReader &xml, bool tokens);
-    void loadSetsFromXml(QXmlStreamReader &xml);
+    // Ids of the background loads in progress, 0 if none
+    int cardDatabaseLoadId, tokenDatabaseLoadId, lastLoadId;
+    void startLoad(const QString &path, bool tokens);
+    void addSets(const SetDataList &loadedSets);
+    void addCards(const CardDataList &loadedCards, bool tokens);
+    LoadStatus finishLoad(const QString &path, bool tokens, LoadStatus status);
 
     CardInfo *getCardFromMap(CardNameMap &cardMap, const QString &cardName, bool createIfNotFound);
     void checkUnknownSets();
@@ -271,28 +339,42 @@ public:
     bool saveToFile(const QString &fileName, bool tokens = false);
     QStringList getAllColors() const;
     QStringList getAllMainCardTypes() const;
+    bool isLoading() const { return cardDatabaseLoadId || tokenDatabaseLoadId; }
+    // Runs a local event loop until the background loads have finished.
+    void waitUntilLoaded();
     LoadStatus getLoadStatus() const { return loadStatus; }
     bool getLoadSuccess() const { return loadStatus == Ok; }
     void cacheCardPixmaps(const QStringList &cardNames);
-    void loadImage(CardInfo *card);
+    void loadImage(CardInfo *card, PictureLoader::Priority priority = PictureLoader::VisiblePriority);
     bool hasDetectedFirstRun();
+    QString intern(const QString &string);
+    QStringList intern(const QStringList &list);
+    void notifyCardInfoChanged(CardInfo *card) { emit cardInfoChanged(card); }
+    CardPixmapCache &getPixmapCache() { return pixmapCache; }
+    int newPixmapCacheId() { return ++lastPixmapCacheId; }
 public slots:
     void clearPixmapCache();
     LoadStatus loadCardDatabase(const QString &path, bool tokens = false);
     void loadCustomCardDatabases(const QString &path);
     void emitCardListChanged();
 private slots:
-    void imageLoaded(CardInfo *card, QImage image);
+    void imageLoaded(CardInfo *card, const QList<QImage> &levels);
     void picDownloadChanged();
     void picDownloadHqChanged();
     void picsPathChanged();
+    void pixmapCacheSizeChanged(int newSizeInMBs);
 
     void loadCardDatabase();
     void loadTokenDatabase();
+    void setsLoaded(int loadId, const SetDataList &loadedSets);
+    void cardsLoaded(int loadId, const CardDataList &loadedCards);
+    void loadFinished(int loadId, LoadStatus status);
 signals:
     void cardListChanged();
+    void databaseLoaded();
     void cardAdded(CardInfo *card);
     void cardRemoved(CardInfo *card);
+    void cardInfoChanged(CardInfo *card);
 };
 
 #endif
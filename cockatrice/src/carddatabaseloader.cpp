@@ -0,0 +1,352 @@
+#include "carddatabaseloader.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QXmlStreamReader>
+
+const int CardDatabaseLoader::versionNeeded = 3;
+const quint32 CardDatabaseLoader::snapshotMagic = 0x43444253; // "CDBS"
+const quint32 CardDatabaseLoader::snapshotVersion = 1;
+const int CardDatabaseLoader::cardsPerBatch = 500;
+
+// Below this size, splitting the file is not worth starting threads for.
+static const int minParallelParseSize = 512 * 1024;
+
+QDataStream &operator<<(QDataStream &stream, const SetData &set)
+{
+    return stream << set.shortName << set.longName << set.setType << set.releaseDate;
+}
+
+QDataStream &operator>>(QDataStream &stream, SetData &set)
+{
+    return stream >> set.shortName >> set.longName >> set.setType >> set.releaseDate;
+}
+
+QDataStream &operator<<(QDataStream &stream, const CardData &card)
+{
+    return stream << card.name << card.manacost << card.cmc << card.cardtype << card.powtough << card.text
+                  << card.colors << card.relatedCards << card.sets
+                  << card.customPicURLs << card.customPicURLsHq << card.muIds
+                  << (qint32) card.tableRow << (qint32) card.loyalty
+                  << card.cipt << card.isToken << card.upsideDownArt;
+}
+
+QDataStream &operator>>(QDataStream &stream, CardData &card)
+{
+    qint32 tableRow, loyalty;
+    stream >> card.name >> card.manacost >> card.cmc >> card.cardtype >> card.powtough >> card.text
+           >> card.colors >> card.relatedCards >> card.sets
+           >> card.customPicURLs >> card.customPicURLsHq >> card.muIds
+           >> tableRow >> loyalty
+           >> card.cipt >> card.isToken >> card.upsideDownArt;
+    card.tableRow = tableRow;
+    card.loyalty = loyalty;
+    return stream;
+}
+
+// Position of the next <tag ...> start tag at or after from, or -1.
+static int findStartTag(const QByteArray &data, const QByteArray &tag, int from, int to)
+{
+    const QByteArray pattern = "<" + tag;
+    int pos = from;
+    while ((pos = data.indexOf(pattern, pos)) != -1 && (pos < to)) {
+        const char next = (pos + pattern.size() < data.size()) ? data[pos + pattern.size()] : '\0';
+        if ((next == '>') || (next == '/') || (next == ' ') || (next == '\t') || (next == '\r') || (next == '\n'))
+            return pos;
+        pos += pattern.size();
+    }
+    return -1;
+}
+
+class CardChunkParser : public QRunnable {
+private:
+    QByteArray chunk;
+public:
+    CardDataList cards;
+    CardChunkParser(const QByteArray &_chunk) : chunk(_chunk) { setAutoDelete(false); }
+    void run()
+    {
+        QXmlStreamReader xml(chunk);
+        while (!xml.atEnd())
+            if (xml.readNext() == QXmlStreamReader::StartElement)
+                CardDatabaseLoader::parseCards(xml, cards);
+    }
+};
+
+CardDatabaseLoader::~CardDatabaseLoader()
+{
+    // see PictureLoader::~PictureLoader()
+    thread()->quit();
+}
+
+void CardDatabaseLoader::parseSets(QXmlStreamReader &xml, SetDataList &sets)
+{
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::EndElement)
+            break;
+        if (xml.name() == "set") {
+            SetData set;
+            while (!xml.atEnd()) {
+                if (xml.readNext() == QXmlStreamReader::EndElement)
+                    break;
+                if (xml.name() == "name")
+                    set.shortName = xml.readElementText();
+                else if (xml.name() == "longname")
+                    set.longName = xml.readElementText();
+                else if (xml.name() == "settype")
+                    set.setType = xml.readElementText();
+                else if (xml.name() == "releasedate")
+                    set.releaseDate = QDate::fromString(xml.readElementText(), Qt::ISODate);
+            }
+            sets.append(set);
+        }
+    }
+}
+
+void CardDatabaseLoader::parseCards(QXmlStreamReader &xml, CardDataList &cards)
+{
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::EndElement)
+            break;
+        if (xml.name() == "card") {
+            CardData card;
+            while (!xml.atEnd()) {
+                if (xml.readNext() == QXmlStreamReader::EndElement)
+                    break;
+                if (xml.name() == "name")
+                    card.name = xml.readElementText();
+                else if (xml.name() == "manacost")
+                    card.manacost = xml.readElementText();
+                else if (xml.name() == "cmc")
+                    card.cmc = xml.readElementText();
+                else if (xml.name() == "type")
+                    card.cardtype = xml.readElementText();
+                else if (xml.name() == "pt")
+                    card.powtough = xml.readElementText();
+                else if (xml.name() == "text")
+                    card.text = xml.readElementText();
+                else if (xml.name() == "set") {
+                    QXmlStreamAttributes attrs = xml.attributes();
+                    QString setName = xml.readElementText();
+                    card.sets.append(setName);
+                    if (attrs.hasAttribute("muId")) {
+                        card.muIds[setName] = attrs.value("muId").toString().toInt();
+                    }
+                    if (attrs.hasAttribute("picURL")) {
+                        card.customPicURLs[setName] = attrs.value("picURL").toString();
+                    }
+                    if (attrs.hasAttribute("picURLHq")) {
+                        card.customPicURLsHq[setName] = attrs.value("picURLHq").toString();
+                    }
+                } else if (xml.name() == "color")
+                    card.colors << xml.readElementText();
+                else if (xml.name() == "related")
+                    card.relatedCards << xml.readElementText();
+                else if (xml.name() == "tablerow")
+                    card.tableRow = xml.readElementText().toInt();
+                else if (xml.name() == "cipt")
+                    card.cipt = (xml.readElementText() == "1");
+                else if (xml.name() == "upsidedown")
+                    card.upsideDownArt = (xml.readElementText() == "1");
+                else if (xml.name() == "loyalty")
+                    card.loyalty = xml.readElementText().toInt();
+                else if (xml.name() == "token")
+                    card.isToken = xml.readElementText().toInt();
+            }
+            cards.append(card);
+        }
+    }
+}
+
+LoadStatus CardDatabaseLoader::parseXml(const QByteArray &data, SetDataList &sets, CardDataList &cards)
+{
+    // Cut the <cards> element out of the document. What remains (the root element
+    // and the sets) is small and parsed right here, the cards are parsed in parallel.
+    int cardsBegin = findStartTag(data, "cards", 0, data.size());
+    int cardsEnd = -1;
+    QByteArray outline = data;
+    if (cardsBegin != -1) {
+        const int closingTag = data.indexOf("</cards>", cardsBegin);
+        const int openingTagEnd = data.indexOf('>', cardsBegin);
+        if ((closingTag == -1) || (openingTagEnd == -1) || (data[openingTagEnd - 1] == '/'))
+            cardsBegin = -1;
+        else {
+            cardsEnd = closingTag;
+            outline = data.left(cardsBegin) + data.mid(closingTag + 8);
+            cardsBegin = openingTagEnd + 1;
+        }
+    }
+
+    QXmlStreamReader xml(outline);
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement) {
+            if (xml.name() != "cockatrice_carddatabase")
+                return Invalid;
+            int version = xml.attributes().value("version").toString().toInt();
+            if (version < versionNeeded) {
+                qDebug() << "CardDatabaseLoader: Version too old: " << version;
+                return VersionTooOld;
+            }
+            while (!xml.atEnd()) {
+                if (xml.readNext() == QXmlStreamReader::EndElement)
+                    break;
+                if (xml.name() == "sets")
+                    parseSets(xml, sets);
+            }
+        }
+    }
+    if (cardsBegin == -1)
+        return Ok;
+
+    // Split the cards into chunks at <card> boundaries. The chunks are wrapped in a
+    // <cards> element of their own, which is what parseCards() expects.
+    int chunkCount = 1;
+    if (cardsEnd - cardsBegin >= minParallelParseSize)
+        chunkCount = qMax(QThread::idealThreadCount(), 1);
+    const int chunkSize = (cardsEnd - cardsBegin) / chunkCount + 1;
+
+    QList<CardChunkParser *> parsers;
+    int chunkBegin = cardsBegin;
+    while (chunkBegin < cardsEnd) {
+        int chunkEnd = findStartTag(data, "card", chunkBegin + chunkSize, cardsEnd);
+        if (chunkEnd == -1)
+            chunkEnd = cardsEnd;
+        parsers.append(new CardChunkParser("<cards>" + data.mid(chunkBegin, chunkEnd - chunkBegin) + "</cards>"));
+        chunkBegin = chunkEnd;
+    }
+
+    if (parsers.size() == 1)
+        parsers.first()->run();
+    else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(parsers.size());
+        for (int i = 0; i < parsers.size(); ++i)
+            pool.start(parsers[i]);
+        pool.waitForDone();
+    }
+
+    // Keep the document order, later cards replace earlier ones with the same name.
+    for (int i = 0; i < parsers.size(); ++i)
+        cards.append(parsers[i]->cards);
+    qDeleteAll(parsers);
+
+    return Ok;
+}
+
+bool CardDatabaseLoader::readSnapshot(const QString &fileName, qint64 fileSize, qint64 fileModified, QByteArray &fileData, bool &outdated, SetDataList &sets, CardDataList &cards)
+{
+    QFile snapshotFile(snapshotFileName(fileName));
+    if (!snapshotFile.open(QIODevice::ReadOnly))
+        return false;
+
+    const qint64 snapshotSize = snapshotFile.size();
+    uchar *mapped = snapshotFile.map(0, snapshotSize);
+    QByteArray snapshot = mapped ? QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), snapshotSize) : snapshotFile.readAll();
+
+    QDataStream stream(snapshot);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic, version;
+    qint64 snapshotFileSize, snapshotFileModified;
+    QByteArray snapshotFileHash;
+    stream >> magic >> version;
+    if ((magic != snapshotMagic) || (version != snapshotVersion))
+        return false;
+    stream >> snapshotFileSize >> snapshotFileModified >> snapshotFileHash;
+
+    // A changed modification time alone does not invalidate the snapshot,
+    // e.g. when the file was copied or rewritten with the same contents.
+    outdated = (snapshotFileSize != fileSize) || (snapshotFileModified != fileModified);
+    if (outdated) {
+        if (fileData.isEmpty()) {
+            QFile file(fileName);
+            if (!file.open(QIODevice::ReadOnly))
+                return false;
+            fileData = file.readAll();
+        }
+        if (QCryptographicHash::hash(fileData, QCryptographicHash::Sha1) != snapshotFileHash)
+            return false;
+    }
+
+    stream >> sets >> cards;
+    if (stream.status() != QDataStream::Ok) {
+        sets.clear();
+        cards.clear();
+        return false;
+    }
+    return true;
+}
+
+void CardDatabaseLoader::writeSnapshot(const QString &fileName, qint64 fileSize, qint64 fileModified, const QByteArray &fileData, const SetDataList &sets, const CardDataList &cards)
+{
+    // Write to a temporary file first, so that a reader never sees half a snapshot.
+    const QString snapshotName = snapshotFileName(fileName);
+    QFile snapshotFile(snapshotName + ".tmp");
+    if (!snapshotFile.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&snapshotFile);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << snapshotMagic << snapshotVersion
+           << fileSize << fileModified << QCryptographicHash::hash(fileData, QCryptographicHash::Sha1)
+           << sets << cards;
+    snapshotFile.close();
+
+    if (stream.status() != QDataStream::Ok) {
+        snapshotFile.remove();
+        return;
+    }
+    QFile::remove(snapshotName);
+    if (!snapshotFile.rename(snapshotName))
+        snapshotFile.remove();
+}
+
+LoadStatus CardDatabaseLoader::load(const QString &fileName, SetDataList &sets, CardDataList &cards)
+{
+    const QFileInfo fileInfo(fileName);
+    if (!fileInfo.isFile() || !fileInfo.isReadable())
+        return FileError;
+    const qint64 fileSize = fileInfo.size();
+    const qint64 fileModified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    QByteArray fileData;
+    bool outdated = false;
+    if (readSnapshot(fileName, fileSize, fileModified, fileData, outdated, sets, cards)) {
+        qDebug() << "CardDatabaseLoader: loaded snapshot of" << fileName;
+        if (outdated)
+            writeSnapshot(fileName, fileSize, fileModified, fileData, sets, cards);
+        return Ok;
+    }
+
+    if (fileData.isEmpty()) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly))
+            return FileError;
+        fileData = file.readAll();
+    }
+
+    const LoadStatus status = parseXml(fileData, sets, cards);
+    if ((status == Ok) && !cards.isEmpty())
+        writeSnapshot(fileName, fileSize, fileModified, fileData, sets, cards);
+    return status;
+}
+
+void CardDatabaseLoader::loadFile(int loadId, const QString &fileName)
+{
+    SetDataList sets;
+    CardDataList cards;
+    const LoadStatus status = fileName.isEmpty() ? NotLoaded : load(fileName, sets, cards);
+
+    // Hand the cards over in batches, so that the GUI thread stays responsive
+    // while they are added to the database.
+    emit setsLoaded(loadId, sets);
+    for (int i = 0; i < cards.size(); i += cardsPerBatch)
+        emit cardsLoaded(loadId, cards.mid(i, cardsPerBatch));
+    emit loadFinished(loadId, status);
+}
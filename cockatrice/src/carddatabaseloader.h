@@ -0,0 +1,95 @@
+#ifndef CARDDATABASELOADER_H
+#define CARDDATABASELOADER_H
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QDate>
+#include <QStringList>
+#include <QMetaType>
+
+class QDataStream;
+class QXmlStreamReader;
+
+typedef QMap<QString, QString> QStringMap;
+
+// If we don't typedef this, CardInfo::CardInfo will refuse to compile on OS X < 10.9
+typedef QMap<QString, int> MuidMap;
+
+enum LoadStatus { Ok, VersionTooOld, Invalid, NotLoaded, FileError, NoCards };
+
+/*
+ * The contents of a <set> element, before it is turned into a CardSet.
+ */
+class SetData {
+public:
+    QString shortName, longName, setType;
+    QDate releaseDate;
+};
+
+/*
+ * The contents of a <card> element, before it is turned into a CardInfo.
+ * Sets are referenced by their short name.
+ */
+class CardData {
+public:
+    QString name, manacost, cmc, cardtype, powtough, text;
+    QStringList colors, relatedCards, sets;
+    QStringMap customPicURLs, customPicURLsHq;
+    MuidMap muIds;
+    int tableRow, loyalty;
+    bool cipt, isToken, upsideDownArt;
+    CardData() : tableRow(0), loyalty(0), cipt(false), isToken(false), upsideDownArt(false) { }
+};
+
+typedef QList<SetData> SetDataList;
+typedef QList<CardData> CardDataList;
+
+QDataStream &operator<<(QDataStream &stream, const SetData &set);
+QDataStream &operator>>(QDataStream &stream, SetData &set);
+QDataStream &operator<<(QDataStream &stream, const CardData &card);
+QDataStream &operator>>(QDataStream &stream, CardData &card);
+
+Q_DECLARE_METATYPE(SetDataList)
+Q_DECLARE_METATYPE(CardDataList)
+Q_DECLARE_METATYPE(LoadStatus)
+
+/*
+ * Reads card database files without touching the CardDatabase, so that it
+ * can run on a thread of its own.
+ *
+ * Every successfully parsed file is stored as a binary snapshot next to it
+ * (cards.xml -> cards.xml.cache). As long as the file's size and modification
+ * time, or failing that its SHA-1 hash, match the snapshot, the snapshot is
+ * read instead of the XML. Otherwise the <card> elements are split into one
+ * chunk per CPU core and the chunks are parsed in parallel.
+ */
+class CardDatabaseLoader : public QObject {
+    Q_OBJECT
+private:
+    static const quint32 snapshotMagic;
+    static const quint32 snapshotVersion;
+    static const int cardsPerBatch;
+
+    static QString snapshotFileName(const QString &fileName) { return fileName + ".cache"; }
+    static bool readSnapshot(const QString &fileName, qint64 fileSize, qint64 fileModified, QByteArray &fileData, bool &outdated, SetDataList &sets, CardDataList &cards);
+    static void writeSnapshot(const QString &fileName, qint64 fileSize, qint64 fileModified, const QByteArray &fileData, const SetDataList &sets, const CardDataList &cards);
+    static LoadStatus parseXml(const QByteArray &data, SetDataList &sets, CardDataList &cards);
+    static void parseSets(QXmlStreamReader &xml, SetDataList &sets);
+public:
+    static const int versionNeeded;
+
+    ~CardDatabaseLoader();
+
+    // Reads a file in the calling thread.
+    static LoadStatus load(const QString &fileName, SetDataList &sets, CardDataList &cards);
+    static void parseCards(QXmlStreamReader &xml, CardDataList &cards);
+public slots:
+    void loadFile(int loadId, const QString &fileName);
+signals:
+    void setsLoaded(int loadId, const SetDataList &sets);
+    void cardsLoaded(int loadId, const CardDataList &cards);
+    void loadFinished(int loadId, LoadStatus status);
+};
+
+#endif
@@ -4,11 +4,12 @@
 #define CARDDBMODEL_COLUMNS 5
 
 CardDatabaseModel::CardDatabaseModel(CardDatabase *_db, QObject *parent)
-    : QAbstractListModel(parent), db(_db)
+    : QAbstractListModel(parent), db(_db), sortKeys(CARDDBMODEL_COLUMNS)
 {
     connect(db, SIGNAL(cardListChanged()), this, SLOT(updateCardList()));
     connect(db, SIGNAL(cardAdded(CardInfo *)), this, SLOT(cardAdded(CardInfo *)));
     connect(db, SIGNAL(cardRemoved(CardInfo *)), this, SLOT(cardRemoved(CardInfo *)));
+    connect(db, SIGNAL(cardInfoChanged(CardInfo *)), this, SLOT(cardInfoChanged(CardInfo *)));
     updateCardList();
 }
 
@@ -35,28 +36,73 @@ QVariant CardDatabaseModel::data(const QModelIndex &index, int role) const
     if (role != Qt::DisplayRole && role != SortRole)
         return QVariant();
 
+    if (role == SortRole)
+        return getSortString(index.row(), index.column());
+
     CardInfo *card = cardList.at(index.row());
     switch (index.column()){
         case NameColumn: return card->getName();
-        case SetListColumn: {
-            QStringList setList;
-            const QList<CardSet *> &sets = card->getSets();
-            for (int i = 0; i < sets.size(); i++)
-            {
-                if(sets[i]->getEnabled())
-                    setList << sets[i]->getShortName();
-            }
-            return setList.join(", ");
-        }
-        case ManaCostColumn: return role == SortRole ?
-            QString("%1%2").arg(card->getCmc(), 4, QChar('0')).arg(card->getManaCost()) :
-            card->getManaCost();
+        case SetListColumn: return setLists.at(index.row());
+        case ManaCostColumn: return card->getManaCost();
         case CardTypeColumn: return card->getCardType();
         case PTColumn: return card->getPowTough();
         default: return QVariant();
     }
 }
 
+QString CardDatabaseModel::getSetList(const CardInfo *card)
+{
+    QStringList setList;
+    const QList<CardSet *> &sets = card->getSets();
+    for (int i = 0; i < sets.size(); i++)
+    {
+        if(sets[i]->getEnabled())
+            setList << sets[i]->getShortName();
+    }
+    return setList.join(", ");
+}
+
+QString CardDatabaseModel::getSortString(int row, int column) const
+{
+    CardInfo *card = cardList.at(row);
+    switch (column){
+        case NameColumn: return card->getName();
+        case SetListColumn: return setLists.at(row);
+        case ManaCostColumn: return QString("%1%2").arg(card->getCmc(), 4, QChar('0')).arg(card->getManaCost());
+        case CardTypeColumn: return card->getCardType();
+        case PTColumn: return card->getPowTough();
+        default: return QString();
+    }
+}
+
+CardSortKey CardDatabaseModel::getSortKey(int row, int column) const
+{
+#if QT_VERSION >= 0x050200
+    return collator.sortKey(getSortString(row, column));
+#else
+    return getSortString(row, column);
+#endif
+}
+
+int CardDatabaseModel::compareRows(int leftRow, int rightRow, int column) const
+{
+    if (column >= sortKeys.size())
+        return 0;
+
+    QList<CardSortKey> &keys = sortKeys[column];
+    if (keys.isEmpty() && !cardList.isEmpty()) {
+        keys.reserve(cardList.size());
+        for (int row = 0; row < cardList.size(); ++row)
+            keys.append(getSortKey(row, column));
+    }
+
+#if QT_VERSION >= 0x050200
+    return keys.at(leftRow).compare(keys.at(rightRow));
+#else
+    return QString::localeAwareCompare(keys.at(leftRow), keys.at(rightRow));
+#endif
+}
+
 QVariant CardDatabaseModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (role != Qt::DisplayRole)
@@ -77,10 +123,10 @@ void CardDatabaseModel::updateCardList()
 {
     beginResetModel();
 
-    for (int i = 0; i < cardList.size(); ++i)
-        disconnect(cardList[i], 0, this, 0);
-    
     cardList.clear();
+    setLists.clear();
+    for (int column = 0; column < sortKeys.size(); ++column)
+        sortKeys[column].clear();
 
     foreach(CardInfo * card, db->getCardList())
     {
@@ -94,22 +140,35 @@ void CardDatabaseModel::updateCardList()
             }
         }
 
-        if(hasSet)
-        {
+        if(hasSet) {
             cardList.append(card);
-            connect(card, SIGNAL(cardInfoChanged(CardInfo *)), this, SLOT(cardInfoChanged(CardInfo *)));
+            setLists.append(getSetList(card));
         }
     }
-    
+
+    searchIndex.build(cardList);
+
     endResetModel();
 }
 
+const CardSearchIndex &CardDatabaseModel::getSearchIndex() const
+{
+    if (!searchIndex.isValid())
+        searchIndex.build(cardList);
+    return searchIndex;
+}
+
 void CardDatabaseModel::cardInfoChanged(CardInfo *card)
 {
     const int row = cardList.indexOf(card);
     if (row == -1)
         return;
-    
+
+    setLists[row] = getSetList(card);
+    for (int column = 0; column < sortKeys.size(); ++column)
+        if (!sortKeys[column].isEmpty())
+            sortKeys[column][row] = getSortKey(row, column);
+    searchIndex.invalidate();
     emit dataChanged(index(row, 0), index(row, CARDDBMODEL_COLUMNS - 1));
 }
 
@@ -117,7 +176,12 @@ void CardDatabaseModel::cardAdded(CardInfo *card)
 {
     beginInsertRows(QModelIndex(), cardList.size(), cardList.size());
     cardList.append(card);
-    connect(card, SIGNAL(cardInfoChanged(CardInfo *)), this, SLOT(cardInfoChanged(CardInfo *)));
+    setLists.append(getSetList(card));
+    for (int column = 0; column < sortKeys.size(); ++column)
+        if (!sortKeys[column].isEmpty())
+            sortKeys[column].append(getSortKey(cardList.size() - 1, column));
+    if (searchIndex.isValid())
+        searchIndex.addCard(card);
     endInsertRows();
 }
 
@@ -129,12 +193,19 @@ void CardDatabaseModel::cardRemoved(CardInfo *card)
     
     beginRemoveRows(QModelIndex(), row, row);
     cardList.removeAt(row);
+    setLists.removeAt(row);
+    for (int column = 0; column < sortKeys.size(); ++column)
+        if (!sortKeys[column].isEmpty())
+            sortKeys[column].removeAt(row);
+    searchIndex.invalidate();
     endRemoveRows();
 }
 
 CardDatabaseDisplayModel::CardDatabaseDisplayModel(QObject *parent)
     : QSortFilterProxyModel(parent),
-      isToken(ShowAll)
+      isToken(ShowAll),
+      filterRowsGeneration(-1),
+      filterTreeRowsDirty(true)
 {
     filterTree = NULL;
     setFilterCaseSensitivity(Qt::CaseInsensitive);
@@ -144,11 +215,12 @@ CardDatabaseDisplayModel::CardDatabaseDisplayModel(QObject *parent)
 
 bool CardDatabaseDisplayModel::lessThan(const QModelIndex &left, const QModelIndex &right) const {
 
-    QString leftString = sourceModel()->data(left, CardDatabaseModel::SortRole).toString();
-    QString rightString = sourceModel()->data(right, CardDatabaseModel::SortRole).toString();
+    CardDatabaseModel *model = static_cast<CardDatabaseModel *>(sourceModel());
 
     if (!cardName.isEmpty() && left.column() == CardDatabaseModel::NameColumn)
     {
+        const QString &leftString = model->getCard(left.row())->getName();
+        const QString &rightString = model->getCard(right.row())->getName();
         bool isLeftType = leftString.startsWith(cardName, Qt::CaseInsensitive);
         bool isRightType = rightString.startsWith(cardName, Qt::CaseInsensitive);
 
@@ -161,26 +233,64 @@ bool CardDatabaseDisplayModel::lessThan(const QModelIndex &left, const QModelInd
         if (isRightType && (!isLeftType || rightString.size() == cardName.size()))
             return false;
     }
-    return QString::localeAwareCompare(leftString, rightString) < 0;
+    return model->compareRows(left.row(), right.row(), left.column()) < 0;
+}
+
+void CardDatabaseDisplayModel::updateFilterRows(const CardSearchIndex &index) const
+{
+    if (filterRowsGeneration != index.getGeneration()) {
+        filterRowsGeneration = index.getGeneration();
+        cardNameRows = QBitArray();
+        cardNameRowsTerm.clear();
+        filterTreeRowsDirty = true;
+    }
+
+    // cards appended to the index since the rows were computed
+    int row = cardNameRows.size();
+    if (!cardNameRows.isNull() && (row < index.size())) {
+        cardNameRows.resize(index.size());
+        for (; row < index.size(); ++row)
+            cardNameRows.setBit(row, index.getCard(row)->getName().contains(cardNameRowsTerm, Qt::CaseInsensitive));
+    }
+    row = filterTreeRows.size();
+    if (!filterTreeRowsDirty && (row < index.size())) {
+        filterTreeRows.resize(index.size());
+        for (; row < index.size(); ++row)
+            filterTreeRows.setBit(row, (filterTree == NULL) || filterTree->acceptsCard(index.getCard(row)));
+    }
+
+    if (cardNameRows.isNull() || (cardNameRowsTerm != cardName)) {
+        // a term extending the previous one can only narrow down its result
+        if (!cardNameRows.isNull() && !cardNameRowsTerm.isEmpty() && cardName.contains(cardNameRowsTerm, Qt::CaseInsensitive))
+            cardNameRows = index.getNameRows(cardName, cardNameRows);
+        else
+            cardNameRows = index.getNameRows(cardName);
+        cardNameRowsTerm = cardName;
+    }
+
+    if (filterTreeRowsDirty) {
+        filterTreeRows = (filterTree != NULL) ? filterTree->acceptedRows(index) : index.getAllRows();
+        filterTreeRowsDirty = false;
+    }
 }
 
 bool CardDatabaseDisplayModel::filterAcceptsRow(int sourceRow, const QModelIndex & /*sourceParent*/) const
 {
-    CardInfo const *info = static_cast<CardDatabaseModel *>(sourceModel())->getCard(sourceRow);
+    const CardSearchIndex &index = static_cast<CardDatabaseModel *>(sourceModel())->getSearchIndex();
+    CardInfo const *info = index.getCard(sourceRow);
     
     if (((isToken == ShowTrue) && !info->getIsToken()) || ((isToken == ShowFalse) && info->getIsToken()))
         return false;
 
-    if (!cardName.isEmpty() && !info->getName().contains(cardName, Qt::CaseInsensitive))
+    updateFilterRows(index);
+
+    if (!cardNameRows.testBit(sourceRow))
         return false;
 
     if (!cardNameSet.isEmpty() && !cardNameSet.contains(info->getName()))
         return false;
 
-    if (filterTree != NULL)
-        return filterTree->acceptsCard(info);
-
-    return true;
+    return filterTreeRows.testBit(sourceRow);
 }
 
 void CardDatabaseDisplayModel::clearFilterAll()
@@ -201,10 +311,12 @@ void CardDatabaseDisplayModel::setFilterTree(FilterTree *filterTree)
 
     this->filterTree = filterTree;
     connect(this->filterTree, SIGNAL(changed()), this, SLOT(filterTreeChanged()));
-    invalidate();
+    filterTreeRowsDirty = true;
+    invalidateFilter();
 }
 
 void CardDatabaseDisplayModel::filterTreeChanged()
 {
-    invalidate();
+    filterTreeRowsDirty = true;
+    invalidateFilter();
 }
@@ -5,10 +5,22 @@
 #include <QSortFilterProxyModel>
 #include <QList>
 #include <QSet>
+#include <QVector>
+#if QT_VERSION >= 0x050200
+#include <QCollator>
+#endif
 #include "carddatabase.h"
+#include "cardsearchindex.h"
 
 class FilterTree;
 
+#if QT_VERSION >= 0x050200
+typedef QCollatorSortKey CardSortKey;
+#else
+// compared with QString::localeAwareCompare
+typedef QString CardSortKey;
+#endif
+
 class CardDatabaseModel : public QAbstractListModel {
     Q_OBJECT
 public:
@@ -22,9 +34,25 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
     CardDatabase *getDatabase() const { return db; }
     CardInfo *getCard(int index) const { return cardList[index]; }
+    const CardSearchIndex &getSearchIndex() const;
+    // Compares two rows by the SortRole data of a column.
+    int compareRows(int leftRow, int rightRow, int column) const;
 private:
     QList<CardInfo *> cardList;
+    // the enabled sets of each card, as shown in SetListColumn
+    QStringList setLists;
     CardDatabase *db;
+    mutable CardSearchIndex searchIndex;
+    // Collation keys of the SortRole data, one list per column.
+    // A column's keys are created when it is first sorted by.
+#if QT_VERSION >= 0x050200
+    QCollator collator;
+#endif
+    mutable QVector<QList<CardSortKey> > sortKeys;
+
+    static QString getSetList(const CardInfo *card);
+    QString getSortString(int row, int column) const;
+    CardSortKey getSortKey(int row, int column) const;
 private slots:
     void updateCardList();
     void cardAdded(CardInfo *card);
@@ -42,13 +70,22 @@ private:
     QString searchTerm;
     QSet<QString> cardNameSet, cardTypes, cardColors;
     FilterTree *filterTree;
+
+    // Source rows passing the name filter and the filter tree, taken from
+    // the source model's search index. Cards appended to the source model
+    // are tested one by one; any other change of the index recomputes them.
+    mutable QBitArray cardNameRows, filterTreeRows;
+    mutable QString cardNameRowsTerm;
+    mutable int filterRowsGeneration;
+    mutable bool filterTreeRowsDirty;
+    void updateFilterRows(const CardSearchIndex &index) const;
 public:
     CardDatabaseDisplayModel(QObject *parent = 0);
     void setFilterTree(FilterTree *filterTree);
-    void setIsToken(FilterBool _isToken) { isToken = _isToken; invalidate(); }
+    void setIsToken(FilterBool _isToken) { isToken = _isToken; invalidateFilter(); }
     void setCardNameBeginning(const QString &_beginning) { cardNameBeginning = _beginning; invalidate(); }
     void setCardName(const QString &_cardName) { cardName = _cardName; invalidate(); }
-    void setCardNameSet(const QSet<QString> &_cardNameSet) { cardNameSet = _cardNameSet; invalidate(); }
+    void setCardNameSet(const QSet<QString> &_cardNameSet) { cardNameSet = _cardNameSet; invalidateFilter(); }
     void setSearchTerm(const QString &_searchTerm) { searchTerm = _searchTerm; }
     void setCardText(const QString &_cardText) { cardText = _cardText; invalidate(); }
     void setCardTypes(const QSet<QString> &_cardTypes) { cardTypes = _cardTypes; invalidate(); }
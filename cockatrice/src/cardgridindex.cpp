@@ -0,0 +1,66 @@
+#include "cardgridindex.h"
+#include "carditem.h"
+#include <math.h>
+
+int CardGridIndex::cellOf(qreal coordinate)
+{
+    return (int) floor(coordinate / CELL_SIZE);
+}
+
+void CardGridIndex::build(const QList<CardItem *> &_cards)
+{
+    clear();
+    for (int i = 0; i < _cards.size(); ++i)
+        addCard(_cards[i]);
+}
+
+void CardGridIndex::clear()
+{
+    cards.clear();
+    cells.clear();
+}
+
+void CardGridIndex::addCard(CardItem *card)
+{
+    const int index = cards.size();
+    cards.append(card);
+
+    // Cards are tapped around their center and scaled from it when hovered,
+    // so they never leave the circle around their center which encloses them
+    // at the hovered scale.
+    const QRectF rect = card->boundingRect();
+    const QPointF center = card->pos() + rect.center();
+    const qreal radius = 1.1 * sqrt(rect.width() * rect.width() + rect.height() * rect.height()) / 2;
+
+    const int left = cellOf(center.x() - radius);
+    const int right = cellOf(center.x() + radius);
+    const int top = cellOf(center.y() - radius);
+    const int bottom = cellOf(center.y() + radius);
+    for (int x = left; x <= right; ++x)
+        for (int y = top; y <= bottom; ++y)
+            cells[cellKey(x, y)].append(index);
+}
+
+CardItem *CardGridIndex::cardAt(const QPointF &zonePos) const
+{
+    QHash<quint32, QList<int> >::const_iterator it = cells.constFind(cellKey(cellOf(zonePos.x()), cellOf(zonePos.y())));
+    if (it == cells.constEnd())
+        return 0;
+
+    CardItem *maxZCard = 0;
+    qreal maxZ = -1;
+    const QList<int> &cellCards = it.value();
+    for (int i = 0; i < cellCards.size(); ++i) {
+        CardItem *card = cards[cellCards[i]];
+        if (!card || !card->isVisible())
+            continue;
+        if (!card->boundingRect().contains(card->mapFromParent(zonePos)))
+            continue;
+
+        if (card->getRealZValue() > maxZ) {
+            maxZ = card->getRealZValue();
+            maxZCard = card;
+        }
+    }
+    return maxZCard;
+}
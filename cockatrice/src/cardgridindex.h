@@ -0,0 +1,36 @@
+#ifndef CARDGRIDINDEX_H
+#define CARDGRIDINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QPointF>
+
+class CardItem;
+
+/*
+ * A uniform grid over the cards of a zone, used to find the card under the
+ * mouse without asking the scene for all items at that point.
+ * Every card is entered in all cells it could cover at any rotation and
+ * while scaled up for hovering, so the index only has to be rebuilt when
+ * the cards are moved, not when they are tapped or hovered.
+ */
+class CardGridIndex {
+private:
+    static const int CELL_SIZE = 128;
+
+    QList<QPointer<CardItem> > cards;
+    QHash<quint32, QList<int> > cells;
+
+    static quint32 cellKey(int x, int y) { return ((quint32) (quint16) x << 16) | (quint16) y; }
+    static int cellOf(qreal coordinate);
+    void addCard(CardItem *card);
+public:
+    // The cards have to be children of the zone the index is used with.
+    void build(const QList<CardItem *> &_cards);
+    void clear();
+    // Returns the card with the highest real z value at a point in zone coordinates.
+    CardItem *cardAt(const QPointF &zonePos) const;
+};
+
+#endif
@@ -84,10 +84,9 @@ void CardItem::retranslateUi()
     ptMenu->setTitle(tr("&Power / toughness"));
 }
 
-void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void CardItem::paintFace(QPainter *painter, const QSizeF &translatedSize)
 {
-    painter->save();
-    AbstractCardItem::paint(painter, option, widget);
+    AbstractCardItem::paintFace(painter, translatedSize);
     
     int i = 0;
     QMapIterator<int, int> counterIterator(counters);
@@ -100,12 +99,11 @@ void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
         ++i;
     }
     
-    QSizeF translatedSize = getTranslatedSize(painter);
     qreal scaleFactor = translatedSize.width() / boundingRect().width();
     
     if (!pt.isEmpty()) {
         painter->save();
-        transformPainter(painter, translatedSize, tapAngle);
+        transformPainter(painter, translatedSize, 0);
 
         QStringList ptDbSplit = db->getCard(name)->getPowTough().split("/");
         QStringList ptSplit = pt.split("/");
@@ -123,7 +121,7 @@ void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     if (!annotation.isEmpty()) {
         painter->save();
 
-        transformPainter(painter, translatedSize, tapAngle);
+        transformPainter(painter, translatedSize, 0);
         painter->setBackground(Qt::black);
         painter->setBackgroundMode(Qt::OpaqueMode);
         painter->setPen(Qt::white);
@@ -131,9 +129,14 @@ void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
         painter->drawText(QRectF(4 * scaleFactor, 4 * scaleFactor, translatedSize.width() - 8 * scaleFactor, translatedSize.height() - 8 * scaleFactor), Qt::AlignCenter | Qt::TextWrapAnywhere, annotation);
         painter->restore();
     }
+}
+
+void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    AbstractCardItem::paint(painter, option, widget);
+    
     if (getBeingPointedAt())
         painter->fillRect(boundingRect(), QBrush(QColor(255, 0, 0, 100)));
-    painter->restore();
 }
 
 void CardItem::setAttacking(bool _attacking)
@@ -148,13 +151,13 @@ void CardItem::setCounter(int _id, int _value)
         counters.insert(_id, _value);
     else
         counters.remove(_id);
-    update();
+    updateFace();
 }
 
 void CardItem::setAnnotation(const QString &_annotation)
 {
     annotation = _annotation;
-    update();
+    updateFace();
 }
 
 void CardItem::setDoesntUntap(bool _doesntUntap)
@@ -165,7 +168,7 @@ void CardItem::setDoesntUntap(bool _doesntUntap)
 void CardItem::setPT(const QString &_pt)
 {
     pt = _pt;
-    update();
+    updateFace();
 }
 
 void CardItem::setAttachedTo(CardItem *_attachedTo)
@@ -179,12 +182,12 @@ void CardItem::setAttachedTo(CardItem *_attachedTo)
         setParentItem(attachedTo->getZone());
         attachedTo->addAttachedCard(this);
         if (zone != attachedTo->getZone())
-            attachedTo->getZone()->reorganizeCards();
+            attachedTo->getZone()->reorganizeCardsFor(attachedTo);
     } else
         setParentItem(zone);
 
     if (zone)
-        zone->reorganizeCards();
+        zone->reorganizeCardsFor(this);
     
     emit updateCardMenu(this);
 }
@@ -202,7 +205,7 @@ void CardItem::resetState()
     setDoesntUntap(false);
     if (scene())
         static_cast<GameScene *>(scene())->unregisterAnimationItem(this);
-    update();
+    updateFace();
 }
 
 void CardItem::processCardInfo(const ServerInfo_Card &info)
@@ -14,7 +14,7 @@ class QColor;
 const int MAX_COUNTERS_ON_CARD = 999;
 const float CARD_WIDTH_HALF = CARD_WIDTH / 2;
 const float CARD_HEIGHT_HALF = CARD_HEIGHT / 2;
-const int ROTATION_DEGREES_PER_FRAME = 10;
+const int ROTATION_DEGREES_PER_FRAME = 15;
 
 class CardItem : public AbstractCardItem {
     Q_OBJECT
@@ -35,6 +35,8 @@ private:
     QMenu *cardMenu, *ptMenu, *moveMenu;
 
     void prepareDelete();
+protected:
+    void paintFace(QPainter *painter, const QSizeF &translatedSize);
 public slots:
     void deleteLater();
 public:
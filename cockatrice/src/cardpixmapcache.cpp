@@ -0,0 +1,120 @@
+#include "cardpixmapcache.h"
+
+const int CardPixmapCache::minLevelWidth = 64;
+
+CardPixmapCache::CardPixmapCache()
+    : hits(0), levelHits(0), misses(0)
+{
+}
+
+void CardPixmapCache::setMaxSize(int megabytes)
+{
+    // Most of the budget goes to the levels; the exact sizes
+    // can be recreated from them quickly.
+    levelCache.setMaxCost(megabytes * 1024 / 4 * 3);
+    sizeCache.setMaxCost(megabytes * 1024 / 4);
+}
+
+quint64 CardPixmapCache::sizeKey(int cardId, const QSize &size)
+{
+    return ((quint64) (quint32) cardId << 32) | ((quint64) (size.width() & 0xffff) << 16) | (quint64) (size.height() & 0xffff);
+}
+
+int CardPixmapCache::costOf(const QPixmap &pixmap)
+{
+    return qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+}
+
+QList<QImage> CardPixmapCache::createLevels(const QImage &image)
+{
+    QList<QImage> levels;
+    if (image.isNull())
+        return levels;
+
+    levels.append(image);
+    while (levels.last().width() / 2 >= minLevelWidth) {
+        const QImage &previous = levels.last();
+        levels.append(previous.scaled(previous.size() / 2, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    }
+    return levels;
+}
+
+void CardPixmapCache::insert(int cardId, const QList<QImage> &levels)
+{
+    if (levels.isEmpty())
+        return;
+
+    Levels *pixmaps = new Levels;
+    int cost = 0;
+    for (int i = 0; i < levels.size(); ++i) {
+        pixmaps->append(QPixmap::fromImage(levels[i]));
+        cost += costOf(pixmaps->last());
+    }
+    levelCache.insert(cardId, pixmaps, cost);
+}
+
+bool CardPixmapCache::findFull(int cardId, QPixmap &pixmap)
+{
+    Levels *levels = levelCache.object(cardId);
+    if (!levels)
+        return false;
+
+    pixmap = levels->first();
+    return true;
+}
+
+bool CardPixmapCache::find(int cardId, const QSize &size, QPixmap &pixmap)
+{
+    const quint64 key = sizeKey(cardId, size);
+    QPixmap *cachedPixmap = sizeCache.object(key);
+    if (cachedPixmap) {
+        ++hits;
+        pixmap = *cachedPixmap;
+        return true;
+    }
+
+    Levels *levels = levelCache.object(cardId);
+    if (!levels) {
+        ++misses;
+        return false;
+    }
+    ++levelHits;
+
+    // the smallest level that does not need to be scaled up
+    int level = 0;
+    while ((level + 1 < levels->size()) && (levels->at(level + 1).width() >= size.width()) && (levels->at(level + 1).height() >= size.height()))
+        ++level;
+
+    const QPixmap &source = levels->at(level);
+    if (source.size().scaled(size, Qt::KeepAspectRatio) == source.size())
+        pixmap = source;
+    else
+        pixmap = source.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    sizeCache.insert(key, new QPixmap(pixmap), costOf(pixmap));
+
+    // forget the sizes of this card which were evicted meanwhile
+    QList<quint64> &cardSizeKeys = sizeKeys[cardId];
+    for (int i = cardSizeKeys.size() - 1; i >= 0; --i)
+        if (!sizeCache.contains(cardSizeKeys[i]))
+            cardSizeKeys.removeAt(i);
+    if (sizeCache.contains(key))
+        cardSizeKeys.append(key);
+    return true;
+}
+
+void CardPixmapCache::remove(int cardId)
+{
+    levelCache.remove(cardId);
+
+    // the exact sizes were scaled from the removed levels
+    const QList<quint64> keys = sizeKeys.take(cardId);
+    for (int i = 0; i < keys.size(); ++i)
+        sizeCache.remove(keys[i]);
+}
+
+void CardPixmapCache::clear()
+{
+    levelCache.clear();
+    sizeCache.clear();
+    sizeKeys.clear();
+}
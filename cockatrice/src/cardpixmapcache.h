@@ -0,0 +1,57 @@
+#ifndef CARDPIXMAPCACHE_H
+#define CARDPIXMAPCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+#include <QSize>
+
+/*
+ * The card pictures, in two tiers which are both kept in LRU order within a
+ * memory budget:
+ *  - the levels of each card: the picture at full size and a few pre-scaled
+ *    halvings of it, created by createLevels() off the GUI thread;
+ *  - pixmaps at the exact sizes requested for painting, scaled from the
+ *    nearest level that is at least as large.
+ * Cards are identified by CardInfo::getPixmapCacheId().
+ */
+class CardPixmapCache {
+private:
+    typedef QList<QPixmap> Levels;
+
+    static const int minLevelWidth;
+
+    QCache<int, Levels> levelCache;
+    QCache<quint64, QPixmap> sizeCache;
+    // the keys in sizeCache of each card; may include keys already evicted
+    QHash<int, QList<quint64> > sizeKeys;
+    int hits, levelHits, misses;
+
+    static quint64 sizeKey(int cardId, const QSize &size);
+    static int costOf(const QPixmap &pixmap);
+public:
+    CardPixmapCache();
+    // The budget in megabytes, shared by both tiers.
+    void setMaxSize(int megabytes);
+
+    // Scales a picture down to its levels, largest first.
+    // Only works on QImage, so it can be called from any thread.
+    static QList<QImage> createLevels(const QImage &image);
+    void insert(int cardId, const QList<QImage> &levels);
+    bool contains(int cardId) const { return levelCache.contains(cardId); }
+    bool findFull(int cardId, QPixmap &pixmap);
+    bool find(int cardId, const QSize &size, QPixmap &pixmap);
+    void remove(int cardId);
+    void clear();
+
+    // Lookups answered from the exact sizes, from the levels, and not at all.
+    int getHits() const { return hits; }
+    int getLevelHits() const { return levelHits; }
+    int getMisses() const { return misses; }
+    // Memory used, in kilobytes
+    int getTotalCost() const { return levelCache.totalCost() + sizeCache.totalCost(); }
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "cardsearchindex.h"
+#include "carddatabase.h"
+
+CardSearchIndex::CardSearchIndex()
+    : generation(0), valid(true)
+{
+}
+
+void CardSearchIndex::addRow(RowList &rowList, int row)
+{
+    // Rows are added in ascending order, so a duplicate can only be the last entry.
+    if (rowList.isEmpty() || (rowList.last() != row))
+        rowList.append(row);
+}
+
+quint64 CardSearchIndex::trigram(const QChar *chars)
+{
+    return ((quint64) chars[0].unicode() << 32) | ((quint64) chars[1].unicode() << 16) | (quint64) chars[2].unicode();
+}
+
+QStringList CardSearchIndex::words(const QString &foldedText)
+{
+    QStringList result;
+    int wordStart = -1;
+    for (int i = 0; i <= foldedText.size(); ++i) {
+        const bool isWordChar = (i < foldedText.size()) && foldedText[i].isLetterOrNumber();
+        if (isWordChar && (wordStart == -1))
+            wordStart = i;
+        else if (!isWordChar && (wordStart != -1)) {
+            result.append(foldedText.mid(wordStart, i - wordStart));
+            wordStart = -1;
+        }
+    }
+    return result;
+}
+
+void CardSearchIndex::WordIndex::clear()
+{
+    wordIds.clear();
+    words.clear();
+    wordRows.clear();
+    wordTrigrams.clear();
+}
+
+void CardSearchIndex::WordIndex::addWord(const QString &word, int row)
+{
+    int id = wordIds.value(word, -1);
+    if (id == -1) {
+        id = words.size();
+        wordIds.insert(word, id);
+        words.append(word);
+        wordRows.append(RowList());
+        for (int i = 0; i + 3 <= word.size(); ++i)
+            addRow(wordTrigrams[trigram(word.constData() + i)], id);
+    }
+    addRow(wordRows[id], row);
+}
+
+void CardSearchIndex::build(const QList<CardInfo *> &_cards)
+{
+    cards.clear();
+    foldedNames.clear();
+    nameTrigrams.clear();
+    textWords.clear();
+    typeWords.clear();
+    setNames.clear();
+    manaCosts.clear();
+    cmcs.clear();
+    colorChars.clear();
+
+    foldedNames.reserve(_cards.size());
+    for (int i = 0; i < _cards.size(); ++i)
+        addCard(_cards[i]);
+
+    ++generation;
+    valid = true;
+}
+
+void CardSearchIndex::addCard(CardInfo *card)
+{
+    const int row = cards.size();
+    cards.append(card);
+
+    const QString foldedName = card->getName().toCaseFolded();
+    foldedNames.append(foldedName);
+    for (int i = 0; i + 3 <= foldedName.size(); ++i)
+        addRow(nameTrigrams[trigram(foldedName.constData() + i)], row);
+
+    const QStringList textWordList = words(card->getText().toCaseFolded());
+    for (int i = 0; i < textWordList.size(); ++i)
+        textWords.addWord(textWordList[i], row);
+
+    const QStringList typeWordList = words(card->getCardType().toCaseFolded());
+    for (int i = 0; i < typeWordList.size(); ++i)
+        typeWords.addWord(typeWordList[i], row);
+
+    const QStringList &colors = card->getColors();
+    for (int i = 0; i < colors.size(); ++i) {
+        const QString foldedColor = colors[i].toCaseFolded();
+        for (int j = 0; j < foldedColor.size(); ++j)
+            addRow(colorChars[foldedColor[j]], row);
+    }
+
+    const SetList &sets = card->getSets();
+    for (int i = 0; i < sets.size(); ++i) {
+        addRow(setNames[sets[i]->getShortName().toCaseFolded()], row);
+        addRow(setNames[sets[i]->getLongName().toCaseFolded()], row);
+    }
+
+    addRow(manaCosts[card->getManaCost()], row);
+    addRow(cmcs[card->getCmc()], row);
+}
+
+QBitArray CardSearchIndex::rowsFromList(const RowList &rowList) const
+{
+    QBitArray result(cards.size());
+    for (int i = 0; i < rowList.size(); ++i)
+        result.setBit(rowList[i]);
+    return result;
+}
+
+QBitArray CardSearchIndex::getNameRows(const QString &term, const QBitArray &within) const
+{
+    const QString foldedTerm = term.toCaseFolded();
+    if (foldedTerm.isEmpty())
+        return within.isNull() ? getAllRows() : within;
+
+    QBitArray result(cards.size());
+    if (!within.isNull()) {
+        for (int row = 0; row < within.size(); ++row)
+            if (within.testBit(row) && foldedNames[row].contains(foldedTerm))
+                result.setBit(row);
+        return result;
+    }
+
+    if (foldedTerm.size() < 3) {
+        for (int row = 0; row < foldedNames.size(); ++row)
+            if (foldedNames[row].contains(foldedTerm))
+                result.setBit(row);
+        return result;
+    }
+
+    // Every matching name contains all trigrams of the term; checking the
+    // rows of the rarest one is enough.
+    const RowList *rarest = 0;
+    for (int i = 0; i + 3 <= foldedTerm.size(); ++i) {
+        QHash<quint64, RowList>::const_iterator it = nameTrigrams.constFind(trigram(foldedTerm.constData() + i));
+        if (it == nameTrigrams.constEnd())
+            return result;
+        if (!rarest || (it.value().size() < rarest->size()))
+            rarest = &it.value();
+    }
+    for (int i = 0; i < rarest->size(); ++i) {
+        const int row = rarest->at(i);
+        if (foldedNames[row].contains(foldedTerm))
+            result.setBit(row);
+    }
+    return result;
+}
+
+QBitArray CardSearchIndex::wordCandidates(const WordIndex &wordIndex, const QString &term) const
+{
+    // Every word of the term is part of a word of a matching text, so the
+    // candidates are the rows which have such a word for each word of the term.
+    const QStringList termWords = words(term.toCaseFolded());
+    if (termWords.isEmpty())
+        return getAllRows();
+
+    QBitArray result;
+    for (int i = 0; i < termWords.size(); ++i) {
+        const QString &termWord = termWords[i];
+
+        // Like in getNameRows(), the words containing the term word are
+        // among the words with its rarest trigram.
+        const RowList *wordIds = 0;
+        for (int j = 0; j + 3 <= termWord.size(); ++j) {
+            QHash<quint64, RowList>::const_iterator it = wordIndex.wordTrigrams.constFind(trigram(termWord.constData() + j));
+            if (it == wordIndex.wordTrigrams.constEnd())
+                return QBitArray(cards.size());
+            if (!wordIds || (it.value().size() < wordIds->size()))
+                wordIds = &it.value();
+        }
+
+        QBitArray wordRows(cards.size());
+        const int wordCount = wordIds ? wordIds->size() : wordIndex.words.size();
+        for (int j = 0; j < wordCount; ++j) {
+            const int id = wordIds ? wordIds->at(j) : j;
+            if (wordIndex.words[id].contains(termWord)) {
+                const RowList &rows = wordIndex.wordRows[id];
+                for (int k = 0; k < rows.size(); ++k)
+                    wordRows.setBit(rows[k]);
+            }
+        }
+
+        if (result.isNull())
+            result = wordRows;
+        else
+            result &= wordRows;
+    }
+    return result;
+}
+
+QBitArray CardSearchIndex::getColorRows(const QChar &colorChar) const
+{
+    return rowsFromList(colorChars.value(QString(colorChar).toCaseFolded()[0]));
+}
+
+QBitArray CardSearchIndex::getSetRows(const QString &setName) const
+{
+    return rowsFromList(setNames.value(setName.toCaseFolded()));
+}
@@ -0,0 +1,84 @@
+#ifndef CARDSEARCHINDEX_H
+#define CARDSEARCHINDEX_H
+
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class CardInfo;
+
+/*
+ * Lookup structures over the rows of a CardDatabaseModel, so that the card
+ * browser filters can be evaluated as bitset operations instead of string
+ * scans over every card.
+ *
+ * Names are indexed by trigram, rules text and type line by word, and the
+ * words themselves by trigram; colors, sets, mana costs and CMCs map to
+ * their cards directly. Lookups that cannot
+ * be answered exactly by the index return a superset of the matching rows
+ * ("candidates") which has to be checked against the cards.
+ *
+ * Cards may be appended cheaply; any other change requires a rebuild, which
+ * changes the generation.
+ */
+class CardSearchIndex {
+private:
+    typedef QVector<int> RowList;
+
+    // The distinct words of a text field, with the rows of each word.
+    // Words are numbered in the order they were first seen.
+    struct WordIndex {
+        QHash<QString, int> wordIds;
+        QVector<QString> words;
+        QVector<RowList> wordRows;
+        // the ids of the words containing each trigram
+        QHash<quint64, RowList> wordTrigrams;
+
+        void clear();
+        void addWord(const QString &word, int row);
+    };
+
+    QList<CardInfo *> cards;
+    QVector<QString> foldedNames;
+    QHash<quint64, RowList> nameTrigrams;
+    WordIndex textWords, typeWords;
+    QHash<QString, RowList> setNames, manaCosts, cmcs;
+    QHash<QChar, RowList> colorChars;
+    int generation;
+    bool valid;
+
+    static void addRow(RowList &rowList, int row);
+    static quint64 trigram(const QChar *chars);
+    static QStringList words(const QString &foldedText);
+    QBitArray rowsFromList(const RowList &rowList) const;
+    QBitArray wordCandidates(const WordIndex &wordIndex, const QString &term) const;
+public:
+    CardSearchIndex();
+    void build(const QList<CardInfo *> &_cards);
+    void addCard(CardInfo *card);
+    // Marks the index as out of date; it has to be rebuilt before the next lookup.
+    void invalidate() { valid = false; }
+    bool isValid() const { return valid; }
+    int getGeneration() const { return generation; }
+
+    int size() const { return cards.size(); }
+    CardInfo *getCard(int row) const { return cards[row]; }
+
+    QBitArray getAllRows() const { return QBitArray(cards.size(), true); }
+    // Rows whose name contains the term, case insensitively.
+    // If given, only the rows set in 'within' are considered.
+    QBitArray getNameRows(const QString &term, const QBitArray &within = QBitArray()) const;
+    QBitArray getTextCandidates(const QString &term) const { return wordCandidates(textWords, term); }
+    QBitArray getTypeCandidates(const QString &term) const { return wordCandidates(typeWords, term); }
+    // Rows with a color containing the character, case insensitively.
+    QBitArray getColorRows(const QChar &colorChar) const;
+    // Rows printed in the set with this short or long name, case insensitively.
+    QBitArray getSetRows(const QString &setName) const;
+    QBitArray getManaCostRows(const QString &manaCost) const { return rowsFromList(manaCosts.value(manaCost)); }
+    QBitArray getCmcRows(const QString &cmc) const { return rowsFromList(cmcs.value(cmc)); }
+};
+
+#endif
@@ -9,8 +9,11 @@
 #include "pb/command_move_card.pb.h"
 #include "pb/serverinfo_user.pb.h"
 
+int CardZone::deferredLayoutLevel = 0;
+QList<QPointer<CardZone> > CardZone::deferredLayoutZones;
+
 CardZone::CardZone(Player *_p, const QString &_name, bool _hasCardAttr, bool _isShufflable, bool _contentsKnown, QGraphicsItem *parent, bool _isView)
-    : AbstractGraphicsItem(parent), player(_p), name(_name), cards(_contentsKnown), view(NULL), menu(NULL), doubleClickAction(0), hasCardAttr(_hasCardAttr), isShufflable(_isShufflable), isView(_isView)
+    : AbstractGraphicsItem(parent), player(_p), name(_name), cards(_contentsKnown), view(NULL), menu(NULL), doubleClickAction(0), hasCardAttr(_hasCardAttr), isShufflable(_isShufflable), isView(_isView), layoutDeferred(false), cardIndexDirty(true)
 {
     if (!isView)
         player->addZone(this);
@@ -41,6 +44,7 @@ void CardZone::clearContents()
         player->deleteCard(cards.at(i));
     }
     cards.clear();
+    invalidateCardIndex();
     emit cardCountChanged();
 }
 
@@ -182,13 +186,64 @@ void CardZone::addCard(CardItem *card, bool reorganize, int x, int y)
 
     card->setZone(this);
     addCardImpl(card, x, y);
+    invalidateCardIndex();
+    invalidateLayout(card);
 
     if (reorganize)
-        reorganizeCards();
+        scheduleLayout();
     
     emit cardCountChanged();
 }
 
+void CardZone::reorganizeCards()
+{
+    invalidateLayout(0);
+    scheduleLayout();
+}
+
+void CardZone::reorganizeCardsFor(CardItem *changedCard)
+{
+    invalidateLayout(changedCard);
+    scheduleLayout();
+}
+
+void CardZone::scheduleLayout()
+{
+    if (deferredLayoutLevel) {
+        if (!layoutDeferred) {
+            layoutDeferred = true;
+            deferredLayoutZones.append(this);
+        }
+        return;
+    }
+    reorganizeCardsImpl();
+    invalidateCardIndex();
+}
+
+void CardZone::beginDeferredLayout()
+{
+    ++deferredLayoutLevel;
+}
+
+void CardZone::endDeferredLayout()
+{
+    if (--deferredLayoutLevel > 0)
+        return;
+
+    const QList<QPointer<CardZone> > zones = deferredLayoutZones;
+    deferredLayoutZones.clear();
+
+    // Each zone updates the arrows of the cards its layout actually moved.
+    for (int i = 0; i < zones.size(); ++i) {
+        CardZone *zone = zones[i];
+        if (!zone)
+            continue;
+        zone->layoutDeferred = false;
+        zone->reorganizeCardsImpl();
+        zone->invalidateCardIndex();
+    }
+}
+
 CardItem *CardZone::getCard(int cardId, const QString &cardName)
 {
     CardItem *c = cards.findCard(cardId, false);
@@ -228,8 +283,10 @@ CardItem *CardZone::takeCard(int position, int cardId, bool /*canResize*/)
         view->removeCard(position);
 
     c->setId(cardId);
+    invalidateCardIndex();
+    invalidateLayout(c);
 
-    reorganizeCards();
+    scheduleLayout();
     emit cardCountChanged();
     return c;
 }
@@ -237,11 +294,30 @@ CardItem *CardZone::takeCard(int position, int cardId, bool /*canResize*/)
 void CardZone::removeCard(CardItem *card)
 {
     cards.removeAt(cards.indexOf(card));
-    reorganizeCards();
+    invalidateCardIndex();
+    invalidateLayout(card);
+    scheduleLayout();
     emit cardCountChanged();
     player->deleteCard(card);
 }
 
+CardItem *CardZone::getCardAt(const QPointF &scenePos)
+{
+    if (cardIndexDirty) {
+        // Attached cards are hovered in the zone of the card they are attached to.
+        QList<CardItem *> indexedCards;
+        for (int i = 0; i < cards.size(); ++i) {
+            if (cards[i]->getAttachedTo())
+                continue;
+            indexedCards.append(cards[i]);
+            indexedCards.append(cards[i]->getAttachedCards());
+        }
+        cardIndex.build(indexedCards);
+        cardIndexDirty = false;
+    }
+    return cardIndex.cardAt(mapFromScene(scenePos));
+}
+
 void CardZone::moveAllToZone()
 {
     QList<QVariant> data = static_cast<QAction *>(sender())->data().toList();
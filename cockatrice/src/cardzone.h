@@ -2,7 +2,9 @@
 #define CARDZONE_H
 
 #include <QString>
+#include <QPointer>
 #include "cardlist.h"
+#include "cardgridindex.h"
 #include "abstractgraphicsitem.h"
 #include "translation.h"
 
@@ -15,6 +17,15 @@ class CardDragItem;
 
 class CardZone : public AbstractGraphicsItem {
     Q_OBJECT
+private:
+    // Layouts requested while the layout is deferred, done in endDeferredLayout().
+    static int deferredLayoutLevel;
+    static QList<QPointer<CardZone> > deferredLayoutZones;
+    bool layoutDeferred;
+    void scheduleLayout();
+    // rebuilt on the next lookup once the cards have changed
+    CardGridIndex cardIndex;
+    bool cardIndexDirty;
 protected:
     Player *player;
     QString name;
@@ -29,11 +40,17 @@ protected:
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event);
     void mousePressEvent(QGraphicsSceneMouseEvent *event);
     virtual void addCardImpl(CardItem *card, int x, int y) = 0;
+    virtual void reorganizeCardsImpl() = 0;
+    // Marks the part of the layout which a card is or was in as out of date,
+    // or all of it if the card is null. Zones which always lay out all of
+    // their cards ignore this.
+    virtual void invalidateLayout(CardItem * /*changedCard*/) { }
 signals:
     void cardCountChanged();
 public slots:
     void moveAllToZone();
     bool showContextMenu(const QPoint &screenPos);
+    void reorganizeCards();
 public:
     enum { Type = typeZone };
     int type() const { return Type; }
@@ -57,13 +74,24 @@ public:
     // takeCard() finds a card by position and removes it from the zone and from all of its views.
     virtual CardItem *takeCard(int position, int cardId, bool canResize = true);
     void removeCard(CardItem *card);
+    // Lays out the zone after a change to one of its cards, or to a card
+    // attached to one of them.
+    void reorganizeCardsFor(CardItem *changedCard);
+    // getCardAt() finds the topmost card at a scene position, for hovering.
+    CardItem *getCardAt(const QPointF &scenePos);
+    void invalidateCardIndex() { cardIndexDirty = true; }
     ZoneViewZone *getView() const { return view; }
     void setView(ZoneViewZone *_view) { view = _view; }
-    virtual void reorganizeCards() = 0;
     virtual QPointF closestGridPoint(const QPointF &point);
     bool getIsView() const { return isView; }
     bool getAlwaysRevealTopCard() const { return alwaysRevealTopCard; }
     void setAlwaysRevealTopCard(bool _alwaysRevealTopCard) { alwaysRevealTopCard = _alwaysRevealTopCard; }
+
+    // While deferred, zones are laid out only once, when the last
+    // endDeferredLayout() is called, however often their cards change.
+    static void beginDeferredLayout();
+    static void endDeferredLayout();
+    static bool isLayoutDeferred() { return deferredLayoutLevel > 0; }
 };
 
 #endif
@@ -15,11 +15,16 @@
 const QColor DEFAULT_MENTION_COLOR = QColor(194, 31, 47);
 const QColor OTHER_USER_COLOR = QColor(0, 65, 255); // dark blue
 const QString SERVER_MESSAGE_COLOR = "#851515";
+// Messages are kept in one block each, so this bounds the history of every chat and game log.
+const int MAX_MESSAGE_BLOCKS = 5000;
 
 ChatView::ChatView(const TabSupervisor *_tabSupervisor, TabGame *_game, bool _showTimestamps, QWidget *parent)
-    : QTextBrowser(parent), tabSupervisor(_tabSupervisor), game(_game), evenNumber(true), showTimestamps(_showTimestamps), hoveredItemType(HoveredNothing)
+    : QTextBrowser(parent), tabSupervisor(_tabSupervisor), game(_game), evenNumber(true), showTimestamps(_showTimestamps), hoveredItemType(HoveredNothing), appendBatchLevel(0), appendBatchAtBottom(false)
 {
     document()->setDefaultStyleSheet("a { text-decoration: none; color: blue; }");
+    // The oldest messages are dropped from the document once it is full,
+    // so appending and laying out stay as cheap as in a fresh chat.
+    document()->setMaximumBlockCount(MAX_MESSAGE_BLOCKS);
     userContextMenu = new UserContextMenu(tabSupervisor, this, game);
     connect(userContextMenu, SIGNAL(openMessageDialog(QString, bool)), this, SIGNAL(openMessageDialog(QString, bool)));
     
@@ -40,6 +45,9 @@ ChatView::ChatView(const TabSupervisor *_tabSupervisor, TabGame *_game, bool _sh
     setTextInteractionFlags(Qt::TextSelectableByMouse | Qt::LinksAccessibleByMouse);
     setOpenLinks(false);
     connect(this, SIGNAL(anchorClicked(const QUrl &)), this, SLOT(openLink(const QUrl &)));
+
+    connect(settingsCache, SIGNAL(highlightWordsChanged()), this, SLOT(updateHighlightWords()));
+    updateHighlightWords();
 }
 
 void ChatView::retranslateUi()
@@ -47,6 +55,50 @@ void ChatView::retranslateUi()
     userContextMenu->retranslateUi();
 }
 
+void ChatView::updateHighlightWords()
+{
+    highlightedWords.clear();
+    const QStringList words = settingsCache->getHighlightWords().split(' ', QString::SkipEmptyParts);
+    for (int i = 0; i < words.size(); ++i)
+        highlightedWords.insert(words[i].toLower());
+}
+
+bool ChatView::isAtBottom() const
+{
+    // the scroll bar is not updated until the batch is laid out
+    if (appendBatchLevel)
+        return appendBatchAtBottom;
+    return verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+}
+
+void ChatView::scrollToBottom()
+{
+    if (!appendBatchLevel)
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void ChatView::beginAppendBatch()
+{
+    if (appendBatchLevel++)
+        return;
+
+    appendBatchAtBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    // the document is laid out once, when the edit block ends
+    appendBatchCursor = QTextCursor(document());
+    appendBatchCursor.beginEditBlock();
+}
+
+void ChatView::endAppendBatch()
+{
+    if (--appendBatchLevel)
+        return;
+
+    appendBatchCursor.endEditBlock();
+    appendBatchCursor = QTextCursor();
+    if (appendBatchAtBottom)
+        scrollToBottom();
+}
+
 QTextCursor ChatView::prepareBlock(bool same)
 {
     lastSender.clear();
@@ -54,7 +106,15 @@ QTextCursor ChatView::prepareBlock(bool same)
     QTextCursor cursor(document()->lastBlock());
     cursor.movePosition(QTextCursor::End);
     if (same) {
-        cursor.insertHtml("<br>");
+        // A run of messages from one sender still gets one block per message,
+        // joined to look like a single one, so that the block count limit applies.
+        QTextBlockFormat previousFormat = cursor.blockFormat();
+        previousFormat.setBottomMargin(0);
+        cursor.setBlockFormat(previousFormat);
+
+        QTextBlockFormat blockFormat = previousFormat;
+        blockFormat.setBottomMargin(4);
+        cursor.insertBlock(blockFormat);
     } else {
         QTextBlockFormat blockFormat;
         if ((evenNumber = !evenNumber))
@@ -68,15 +128,15 @@ QTextCursor ChatView::prepareBlock(bool same)
 
 void ChatView::appendHtml(const QString &html)
 {
-    bool atBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    bool atBottom = isAtBottom();
     prepareBlock().insertHtml(html);
     if (atBottom)
-        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        scrollToBottom();
 }
 
 void ChatView::appendHtmlServerMessage(const QString &html, bool optionalIsBold, QString optionalFontColor)
 {
-    bool atBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    bool atBottom = isAtBottom();
 
     QString htmlText = "<font color=" + ((optionalFontColor.size() > 0) ? optionalFontColor : SERVER_MESSAGE_COLOR) + ">" + html + "</font>";
 
@@ -85,7 +145,7 @@ void ChatView::appendHtmlServerMessage(const QString &html, bool optionalIsBold,
 
     prepareBlock().insertHtml(htmlText);
     if (atBottom)
-        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        scrollToBottom();
 }
 
 void ChatView::appendCardTag(QTextCursor &cursor, const QString &cardName)
@@ -122,7 +182,7 @@ void ChatView::appendUrlTag(QTextCursor &cursor, QString url)
 
 void ChatView::appendMessage(QString message, QString sender, UserLevelFlags userLevel, bool playerBold)
 {
-    bool atBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    bool atBottom = isAtBottom();
     bool sameSender = (sender == lastSender) && !lastSender.isEmpty();
     QTextCursor cursor = prepareBlock(sameSender);
     lastSender = sender;
@@ -154,8 +214,8 @@ void ChatView::appendMessage(QString message, QString sender, UserLevelFlags use
     } else {
         if (!sender.isEmpty() && tabSupervisor->getUserListsTab()) {
             const int pixelSize = QFontInfo(cursor.charFormat().font()).pixelSize();
-            QMap<QString, UserListTWI *> buddyList = tabSupervisor->getUserListsTab()->getBuddyList()->getUsers();
-            cursor.insertImage(UserLevelPixmapGenerator::generatePixmap(pixelSize, userLevel, buddyList.contains(sender)).toImage());
+            const bool isBuddy = tabSupervisor->getUserListsTab()->getUserDirectory().isBuddy(sender);
+            cursor.insertImage(UserLevelPixmapGenerator::generatePixmap(pixelSize, userLevel, isBuddy).toImage());
             cursor.insertText(" ");
         }
         cursor.setCharFormat(senderFormat);
@@ -173,7 +233,6 @@ void ChatView::appendMessage(QString message, QString sender, UserLevelFlags use
     cursor.setCharFormat(defaultFormat);
 
     bool mentionEnabled = settingsCache->getChatMention();
-    highlightedWords = settingsCache->getHighlightWords().split(' ', QString::SkipEmptyParts);
 
     // parse the message
     while (message.size())
@@ -208,7 +267,7 @@ void ChatView::appendMessage(QString message, QString sender, UserLevelFlags use
     }
 
     if (atBottom)
-        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+        scrollToBottom();
 }
 
 void ChatView::checkTag(QTextCursor &cursor, QString &message)
@@ -267,11 +326,12 @@ void ChatView::checkMention(QTextCursor &cursor, QString &message, QString &send
     QString fullMentionUpToSpaceOrEnd = (firstSpace == -1) ? message.mid(1) : message.mid(1, firstSpace - 1);
     QString mentionIntact = fullMentionUpToSpaceOrEnd;
 
-    QMap<QString, UserListTWI *> userList = tabSupervisor->getUserListsTab()->getAllUsersList()->getUsers();
+    const UserDirectory &userDirectory = tabSupervisor->getUserListsTab()->getUserDirectory();
 
     while (fullMentionUpToSpaceOrEnd.size())
     {
-        if (isFullMentionAValidUser(userList, fullMentionUpToSpaceOrEnd)) // Is there a user online named this?
+        QString correctUserName = userDirectory.getUserNameCaseInsensitive(fullMentionUpToSpaceOrEnd);
+        if (!correctUserName.isEmpty()) // Is there a user online named this?
         {
             if (userName.toLower() == fullMentionUpToSpaceOrEnd.toLower()) // Is this user you?
             {
@@ -287,9 +347,7 @@ void ChatView::checkMention(QTextCursor &cursor, QString &message, QString &send
                     showSystemPopup(ref);
                 }
             } else {
-                QString correctUserName = getNameFromUserList(userList, fullMentionUpToSpaceOrEnd);
-                UserListTWI *vlu = userList.value(correctUserName);
-                mentionFormatOtherUser.setAnchorHref("user://" + QString::number(vlu->getUserInfo().user_level()) + "_" + correctUserName);
+                mentionFormatOtherUser.setAnchorHref("user://" + QString::number(userDirectory.getUserLevel(correctUserName)) + "_" + correctUserName);
                 cursor.insertText("@" + correctUserName, mentionFormatOtherUser);
 
                 message = message.mid(correctUserName.size() + 1);
@@ -352,18 +410,15 @@ void ChatView::checkWord(QTextCursor &cursor, QString &message)
     }
 
     // check word mentions
-    foreach (QString word, highlightedWords)
+    if (highlightedWords.contains(fullWordUpToSpaceOrEnd.toLower()))
     {
-        if (fullWordUpToSpaceOrEnd.compare(word, Qt::CaseInsensitive) == 0)
-        {
-            // You have received a valid mention of custom word!!
-            highlightFormat.setBackground(QBrush(getCustomHighlightColor()));
-            highlightFormat.setForeground(settingsCache->getChatHighlightForeground() ? QBrush(Qt::white) : QBrush(Qt::black));
-            cursor.insertText(fullWordUpToSpaceOrEnd, highlightFormat);
-            cursor.insertText(rest, defaultFormat);
-            QApplication::alert(this);
-            return;
-        }
+        // You have received a valid mention of custom word!!
+        highlightFormat.setBackground(QBrush(getCustomHighlightColor()));
+        highlightFormat.setForeground(settingsCache->getChatHighlightForeground() ? QBrush(Qt::white) : QBrush(Qt::black));
+        cursor.insertText(fullWordUpToSpaceOrEnd, highlightFormat);
+        cursor.insertText(rest, defaultFormat);
+        QApplication::alert(this);
+        return;
     }
 
     // not a special word; just print it
@@ -436,32 +491,6 @@ QColor ChatView::getCustomHighlightColor() {
     return customColor.isValid() ? customColor : DEFAULT_MENTION_COLOR;
 }
 
-/**
-   Returns the correct case version of the provided username, if no correct casing version
-   was found then the provided name is not available and will return an empty QString.
- */
-QString ChatView::getNameFromUserList(QMap<QString, UserListTWI *> &userList, QString &userName) {
-    QMap<QString, UserListTWI *>::iterator i;
-    QString lowerUserName = userName.toLower();
-    for (i = userList.begin(); i != userList.end(); ++i) {
-        if (i.key().toLower() == lowerUserName)
-            return i.key();
-    }
-    return QString();
-}
-
-bool ChatView::isFullMentionAValidUser(QMap<QString, UserListTWI *> &userList, QString userNameToMatch)
-{
-    QString userNameToMatchLower = userNameToMatch.toLower();
-    QMap<QString, UserListTWI *>::iterator i;
-    
-    for (i = userList.begin(); i != userList.end(); ++i)
-        if (i.key().toLower() == userNameToMatchLower)
-            return true;
-
-    return false;
-}
-
 void ChatView::clearChat() {
     document()->clear();
     lastSender = "";
@@ -6,6 +6,7 @@
 #include <QTextCursor>
 #include <QColor>
 #include <QAction>
+#include <QSet>
 #include "userlist.h"
 #include "user_level.h"
 #include "tab_supervisor.h"
@@ -30,18 +31,23 @@ private:
     QTextCharFormat highlightFormat;
     QTextCharFormat mentionFormatOtherUser;
     QTextCharFormat defaultFormat;
-    QStringList highlightedWords;
+    // the highlight words from the settings, in lower case
+    QSet<QString> highlightedWords;
     bool evenNumber;
     bool showTimestamps;
     HoveredItemType hoveredItemType;
     QString hoveredContent;
     QAction *messageClicked;
+    // Appends between beginAppendBatch() and endAppendBatch() are laid out together.
+    int appendBatchLevel;
+    bool appendBatchAtBottom;
+    QTextCursor appendBatchCursor;
+    bool isAtBottom() const;
+    void scrollToBottom();
     QTextFragment getFragmentUnderMouse(const QPoint &pos) const;
     QTextCursor prepareBlock(bool same = false);
     void appendCardTag(QTextCursor &cursor, const QString &cardName);
     void appendUrlTag(QTextCursor &cursor, QString url);
-    QString getNameFromUserList(QMap<QString, UserListTWI *> &userList, QString &userName);
-    bool isFullMentionAValidUser(QMap<QString, UserListTWI *> &userList, QString userNameToMatch);
     QColor getCustomMentionColor();
     QColor getCustomHighlightColor();
     bool shouldShowSystemPopup();
@@ -54,6 +60,7 @@ private:
 private slots:
     void openLink(const QUrl &link);
     void actMessageClicked();
+    void updateHighlightWords();
 public:
     ChatView(const TabSupervisor *_tabSupervisor, TabGame *_game, bool _showTimestamps, QWidget *parent = 0);
     void retranslateUi();
@@ -61,6 +68,8 @@ public:
     void appendHtmlServerMessage(const QString &html, bool optionalIsBold = false, QString optionalFontColor = QString());
     void appendMessage(QString message, QString sender = QString(), UserLevelFlags userLevel = UserLevelFlags(), bool playerBold = false);
     void clearChat();
+    void beginAppendBatch();
+    void endAppendBatch();
 protected:
     void enterEvent(QEvent *event);
     void leaveEvent(QEvent *event);
@@ -10,6 +10,7 @@ Q_DECLARE_METATYPE(Response::ResponseCode)
 Q_DECLARE_METATYPE(ClientStatus)
 Q_DECLARE_METATYPE(RoomEvent)
 Q_DECLARE_METATYPE(GameEventContainer)
+Q_DECLARE_METATYPE(QList<ServerMessage>)
 Q_DECLARE_METATYPE(Event_ServerIdentification)
 Q_DECLARE_METATYPE(Event_ConnectionClosed)
 Q_DECLARE_METATYPE(Event_ServerShutdown)
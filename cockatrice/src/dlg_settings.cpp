@@ -44,7 +44,7 @@ GeneralSettingsPage::GeneralSettingsPage()
     picDownloadHqCheckBox.setChecked(settingsCache->getPicDownloadHq());
 
     pixmapCacheEdit.setMinimum(PIXMAPCACHE_SIZE_MIN);
-    // 2047 is the max value to avoid overflowing of QPixmapCache::setCacheLimit(int size)
+    // 2047 is the max value to avoid overflowing the kilobyte costs of CardPixmapCache
     pixmapCacheEdit.setMaximum(PIXMAPCACHE_SIZE_MAX);
     pixmapCacheEdit.setSingleStep(64);
     pixmapCacheEdit.setValue(settingsCache->getPixmapCacheSize());
@@ -74,6 +74,7 @@ GeneralSettingsPage::GeneralSettingsPage()
     personalGrid->addWidget(&highQualityURLLabel, 5, 0, 1, 1);
     personalGrid->addWidget(highQualityURLEdit, 5, 1, 1, 1);
     personalGrid->addWidget(&highQualityURLLinkLabel, 6, 1, 1, 1);
+    personalGrid->addWidget(&pixmapCacheStatsLabel, 7, 0, 1, 2);
     
     highQualityURLLinkLabel.setTextInteractionFlags(Qt::LinksAccessibleByMouse);
     highQualityURLLinkLabel.setOpenExternalLinks(true);
@@ -243,6 +244,23 @@ void GeneralSettingsPage::retranslateUi()
     highQualityURLLabel.setText(tr("Custom Card Download URL:"));
     highQualityURLLinkLabel.setText(QString("<a href='https://github.com/Cockatrice/Cockatrice/wiki/Custom-Download-HQ-URLs'>" + tr("Linking FAQ") + "</a>"));
     clearDownloadedPicsButton.setText(tr("Reset/Clear Downloaded Pictures"));
+    updatePixmapCacheStats();
+}
+
+void GeneralSettingsPage::showEvent(QShowEvent *event)
+{
+    updatePixmapCacheStats();
+    AbstractSettingsPage::showEvent(event);
+}
+
+void GeneralSettingsPage::updatePixmapCacheStats()
+{
+    const CardPixmapCache &pixmapCache = db->getPixmapCache();
+    pixmapCacheStatsLabel.setText(tr("Picture cache: %1 MB in use, %2 hits, %3 rescaled, %4 misses")
+        .arg(pixmapCache.getTotalCost() / 1024)
+        .arg(pixmapCache.getHits())
+        .arg(pixmapCache.getLevelHits())
+        .arg(pixmapCache.getMisses()));
 }
 
 void GeneralSettingsPage::setEnabledStatus(bool status)
@@ -945,6 +963,7 @@ void DlgSettings::closeEvent(QCloseEvent *event)
 {
     bool showLoadError = true;
     QString loadErrorMessage = tr("Unknown Error loading card database");
+    db->waitUntilLoaded();
     LoadStatus loadStatus = db->getLoadStatus();
     qDebug() << "Card Database load status: " << loadStatus;
     switch(loadStatus) {
@@ -20,6 +20,7 @@ class QGroupBox;
 class QCheckBox;
 class QLabel;
 class QCloseEvent;
+class QShowEvent;
 class QSpinBox;
 class QRadioButton;
 class QSpinBox;
@@ -45,7 +46,10 @@ private slots:
     void tokenDatabasePathButtonClicked();
     void languageBoxChanged(int index);
     void setEnabledStatus(bool);
+protected:
+    void showEvent(QShowEvent *event);
 private:
+    void updatePixmapCacheStats();
     QStringList findQmFiles();
     QString languageName(const QString &qmFile);
     QLineEdit *deckPathEdit;
@@ -62,6 +66,7 @@ private:
     QCheckBox picDownloadHqCheckBox;
     QLabel languageLabel;
     QLabel pixmapCacheLabel;
+    QLabel pixmapCacheStatsLabel;
     QLabel deckPathLabel;
     QLabel replaysPathLabel;
     QLabel picsPathLabel;
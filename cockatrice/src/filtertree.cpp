@@ -1,6 +1,7 @@
 #include "filtertree.h"
 #include "cardfilter.h"
 #include "carddatabase.h"
+#include "cardsearchindex.h"
 
 #include <QList>
 
@@ -151,6 +152,36 @@ bool FilterItemList::testTypeOrNot(const CardInfo *info, CardFilter::Attr attr)
     return !testTypeAnd(info, attr);
 }
 
+QBitArray FilterItemList::acceptedRowsAnd(const CardSearchIndex &index) const
+{
+    QList<FilterItem *>::const_iterator i;
+    QBitArray rows = index.getAllRows();
+
+    for (i = childNodes.constBegin(); i != childNodes.constEnd(); i++)
+        if ((*i)->isEnabled())
+            rows &= (*i)->acceptedRows(index);
+
+    return rows;
+}
+
+QBitArray FilterItemList::acceptedRowsOr(const CardSearchIndex &index) const
+{
+    QList<FilterItem *>::const_iterator i;
+    QBitArray rows;
+
+    for (i = childNodes.constBegin(); i != childNodes.constEnd(); i++) {
+        if (!(*i)->isEnabled())
+            continue;
+        if (rows.isNull())
+            rows = (*i)->acceptedRows(index);
+        else
+            rows |= (*i)->acceptedRows(index);
+    }
+
+    // like testTypeOr, a list without enabled items accepts everything
+    return rows.isNull() ? index.getAllRows() : rows;
+}
+
 bool FilterItem::acceptName(const CardInfo *info) const
 {
     return info->getName().contains(term, Qt::CaseInsensitive);
@@ -161,12 +192,9 @@ bool FilterItem::acceptType(const CardInfo *info) const
     return info->getCardType().contains(term, Qt::CaseInsensitive);
 }
 
-bool FilterItem::acceptColor(const CardInfo *info) const
+QString FilterItem::colorTerm() const
 {
-    QStringList::const_iterator i;
     QString converted_term;
-    QString::const_iterator it;
-    int match_count;
 
     converted_term = term;
     converted_term.replace(QString("green"), QString("g"), Qt::CaseInsensitive);
@@ -180,6 +208,18 @@ bool FilterItem::acceptColor(const CardInfo *info) const
     converted_term.replace(QString("wht"), QString("w"), Qt::CaseInsensitive);
     converted_term.replace(QString(" "), QString(""), Qt::CaseInsensitive);
 
+    return converted_term;
+}
+
+bool FilterItem::acceptColor(const CardInfo *info) const
+{
+    QStringList::const_iterator i;
+    QString converted_term;
+    QString::const_iterator it;
+    int match_count;
+
+    converted_term = colorTerm();
+
     /* This is a tricky part, if the filter has multiple colors in it, like UGW,
        then we should match all of them to the card's colors */
     match_count = 0;
@@ -246,6 +286,47 @@ bool FilterItem::acceptCardAttr(const CardInfo *info, CardFilter::Attr attr) con
     }
 }
 
+QBitArray FilterItem::acceptedRows(const CardSearchIndex &index) const
+{
+    QBitArray candidates;
+    QString converted_term;
+    QString::const_iterator it;
+    int row;
+
+    /* the index answers name, set, mana cost and cmc terms exactly, for
+     * the others it narrows down the cards that need to be tested */
+    switch (attr()) {
+        case CardFilter::AttrName:
+            return index.getNameRows(term);
+        case CardFilter::AttrType:
+            candidates = index.getTypeCandidates(term);
+            break;
+        case CardFilter::AttrColor:
+            candidates = index.getAllRows();
+            converted_term = colorTerm();
+            for (it = converted_term.constBegin(); it != converted_term.constEnd(); it++)
+                candidates &= index.getColorRows(*it);
+            break;
+        case CardFilter::AttrText:
+            candidates = index.getTextCandidates(term);
+            break;
+        case CardFilter::AttrSet:
+            return index.getSetRows(term);
+        case CardFilter::AttrManaCost:
+            return index.getManaCostRows(term);
+        case CardFilter::AttrCmc:
+            return index.getCmcRows(term);
+        default:
+            return index.getAllRows(); /* ignore this attribute */
+    }
+
+    for (row = 0; row < candidates.size(); row++)
+        if (candidates.testBit(row) && !acceptCardAttr(index.getCard(row), attr()))
+            candidates.clearBit(row);
+
+    return candidates;
+}
+
 /* need to define these here to make QT happy, otherwise
  * moc doesnt find some of the FilterTreeBranch symbols.
  */
@@ -338,6 +419,46 @@ bool FilterTree::testAttr(const CardInfo *info, const LogicMap *lm) const
     return status;
 }
 
+QBitArray FilterTree::acceptedRows(const CardSearchIndex &index, const LogicMap *lm) const
+{
+    const FilterItemList *fil;
+    QBitArray rows, orRows;
+
+    /* same logic as testAttr, one bit per card */
+    rows = index.getAllRows();
+
+    fil = lm->findTypeList(CardFilter::TypeAnd);
+    if (fil != NULL && fil->isEnabled())
+        rows &= fil->acceptedRowsAnd(index);
+
+    fil = lm->findTypeList(CardFilter::TypeAndNot);
+    if (fil != NULL && fil->isEnabled())
+        rows &= ~fil->acceptedRowsOr(index);
+
+    fil = lm->findTypeList(CardFilter::TypeOr);
+    if (fil == NULL || !fil->isEnabled())
+        return rows;
+    orRows = fil->acceptedRowsOr(index);
+
+    fil = lm->findTypeList(CardFilter::TypeOrNot);
+    if (fil != NULL && fil->isEnabled())
+        orRows |= ~fil->acceptedRowsAnd(index);
+
+    return rows & orRows;
+}
+
+QBitArray FilterTree::acceptedRows(const CardSearchIndex &index) const
+{
+    QList<LogicMap *>::const_iterator i;
+    QBitArray rows = index.getAllRows();
+
+    for (i = childNodes.constBegin(); i != childNodes.constEnd(); i++)
+        if ((*i)->isEnabled())
+            rows &= acceptedRows(index, *i);
+
+    return rows;
+}
+
 bool FilterTree::acceptsCard(const CardInfo *info) const
 {
     QList<LogicMap *>::const_iterator i;
@@ -1,6 +1,7 @@
 #ifndef FILTERTREE_H
 #define FILTERTREE_H
 
+#include <QBitArray>
 #include <QList>
 #include <QMap>
 #include <QObject>
@@ -8,6 +9,7 @@
 #include "cardfilter.h"
 
 class CardInfo;
+class CardSearchIndex;
 
 class FilterTreeNode {
 private:
@@ -92,11 +94,17 @@ public:
     bool testTypeAndNot(const CardInfo *info, CardFilter::Attr attr) const;
     bool testTypeOr(const CardInfo *info, CardFilter::Attr attr) const;
     bool testTypeOrNot(const CardInfo *info, CardFilter::Attr attr) const;
+
+    /* the same tests for all rows of a search index at once */
+    QBitArray acceptedRowsAnd(const CardSearchIndex &index) const;
+    QBitArray acceptedRowsOr(const CardSearchIndex &index) const;
 };
 
 class FilterItem : public FilterTreeNode {
 private:
     FilterItemList *const p;
+
+    QString colorTerm() const;
 public:
     const QString term;
 
@@ -119,6 +127,7 @@ public:
     bool acceptManaCost(const CardInfo *info) const;
     bool acceptCmc(const CardInfo *info) const;
     bool acceptCardAttr(const CardInfo *info, CardFilter::Attr attr) const;
+    QBitArray acceptedRows(const CardSearchIndex &index) const;
 };
 
 class FilterTree : public QObject, public FilterTreeBranch<LogicMap *> {
@@ -137,6 +146,7 @@ private:
                                     CardFilter::Type type);
 
     bool testAttr(const CardInfo *info, const LogicMap *lm) const;
+    QBitArray acceptedRows(const CardSearchIndex &index, const LogicMap *lm) const;
 
     void nodeChanged() const { emit changed(); }
     void preInsertChild(const FilterTreeNode *p, int i) const { emit preInsertRow(p, i); }
@@ -159,6 +169,8 @@ public:
     int index() const { return 0; }
 
     bool acceptsCard(const CardInfo *info) const;
+    /* rows of the index whose card is accepted */
+    QBitArray acceptedRows(const CardSearchIndex &index) const;
     void clear();
 };
 
@@ -10,6 +10,7 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QSet>
 #include <QBasicTimer>
+#include <QCoreApplication>
 #include <QGraphicsView>
 #include <QDebug>
 
@@ -17,6 +18,10 @@ GameScene::GameScene(PhasesToolbar *_phasesToolbar, QObject *parent)
     : QGraphicsScene(parent),
       phasesToolbar(_phasesToolbar),
       viewSize(QSize()),
+      animationFrames(0),
+      droppedFrames(0),
+      animationTickTime(0),
+      reportFrameStats(QCoreApplication::arguments().contains("--debug-output")),
       playerRotation(0)
 {
     animationTimer = new QBasicTimer;
@@ -238,35 +243,32 @@ void GameScene::processViewSizeChange(const QSize &newSize)
     }
 }
 
-void GameScene::updateHover(const QPointF &scenePos)
+CardZone *GameScene::getZoneAt(const QPointF &scenePos) const
 {
-    QList<QGraphicsItem *> itemList = items(scenePos, Qt::IntersectsItemBoundingRect, Qt::DescendingOrder, getViewTransform());
-    
-    // Search for the topmost zone and ignore all cards not belonging to that zone.
-    CardZone *zone = 0;
-    for (int i = 0; i < itemList.size(); ++i)
-        if ((zone = qgraphicsitem_cast<CardZone *>(itemList[i])))
-            break;
-    
-    CardItem *maxZCard = 0;
-    if (zone) {
-        qreal maxZ = -1;
-        for (int i = 0; i < itemList.size(); ++i) {
-            CardItem *card = qgraphicsitem_cast<CardItem *>(itemList[i]);
-            if (!card)
-                continue;
-            if (card->getAttachedTo()) {
-                if (card->getAttachedTo()->getZone() != zone)
-                    continue;
-            } else if (card->getZone() != zone)
-                continue;
-            
-            if (card->getRealZValue() > maxZ) {
-                maxZ = card->getRealZValue();
-                maxZCard = card;
-            }
+    // The zone views are stacked above the players' areas, the newest one on top.
+    for (int i = zoneViews.size() - 1; i >= 0; --i) {
+        ZoneViewZone *zone = zoneViews[i]->getZone();
+        if (zone && zone->isVisible() && zone->boundingRect().contains(zone->mapFromScene(scenePos)))
+            return zone;
+    }
+
+    // The zones of the players do not overlap.
+    for (int i = 0; i < players.size(); ++i) {
+        QMapIterator<QString, CardZone *> zoneIterator(players[i]->getZones());
+        while (zoneIterator.hasNext()) {
+            CardZone *zone = zoneIterator.next().value();
+            if (zone->isVisible() && zone->boundingRect().contains(zone->mapFromScene(scenePos)))
+                return zone;
         }
     }
+    return 0;
+}
+
+void GameScene::updateHover(const QPointF &scenePos)
+{
+    // Search for the topmost zone and ignore all cards not belonging to that zone.
+    CardZone *zone = getZoneAt(scenePos);
+    CardItem *maxZCard = zone ? zone->getCardAt(scenePos) : 0;
     if (hoveredCard && (maxZCard != hoveredCard))
         hoveredCard->setHovered(false);
     if (maxZCard && (maxZCard != hoveredCard))
@@ -284,28 +286,54 @@ bool GameScene::event(QEvent *event)
 
 void GameScene::timerEvent(QTimerEvent * /*event*/)
 {
+    // a frame counts as dropped for every interval that passed without a tick
+    const qint64 sinceLastFrame = frameClock.restart();
+    if (sinceLastFrame >= 2 * frameInterval)
+        droppedFrames += (int) (sinceLastFrame / frameInterval) - 1;
+    ++animationFrames;
+
+    QElapsedTimer tickClock;
+    tickClock.start();
+
     QMutableSetIterator<CardItem *> i(cardsToAnimate);
     while (i.hasNext()) {
         i.next();
         if (!i.value()->animationEvent())
             i.remove();
     }
+
+    animationTickTime += tickClock.nsecsElapsed();
     if (cardsToAnimate.isEmpty())
-        animationTimer->stop();
+        stopAnimation();
 }
 
 void GameScene::registerAnimationItem(AbstractCardItem *card)
 {
     cardsToAnimate.insert(static_cast<CardItem *>(card));
-    if (!animationTimer->isActive())
-        animationTimer->start(10, this);
+    if (!animationTimer->isActive()) {
+        animationFrames = 0;
+        droppedFrames = 0;
+        animationTickTime = 0;
+        frameClock.start();
+        animationTimer->start(frameInterval, this);
+    }
 }
 
 void GameScene::unregisterAnimationItem(AbstractCardItem *card)
 {
     cardsToAnimate.remove(static_cast<CardItem *>(card));
     if (cardsToAnimate.isEmpty())
-        animationTimer->stop();
+        stopAnimation();
+}
+
+void GameScene::stopAnimation()
+{
+    if (!animationTimer->isActive())
+        return;
+
+    animationTimer->stop();
+    if (reportFrameStats && animationFrames)
+        qDebug() << "GameScene: animated" << animationFrames << "frames," << droppedFrames << "dropped, average tick" << animationTickTime / animationFrames / 1000 << "us";
 }
 
 void GameScene::startRubberBand(const QPointF &selectionOrigin)
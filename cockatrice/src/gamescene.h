@@ -2,6 +2,7 @@
 #define GAMESCENE_H
 
 #include <QGraphicsScene>
+#include <QElapsedTimer>
 #include <QList>
 #include <QPointer>
 #include <QSet>
@@ -19,6 +20,8 @@ class GameScene : public QGraphicsScene {
     Q_OBJECT
 private:
     static const int playerAreaSpacing = 5;
+    // All animations advance together, once per display frame.
+    static const int frameInterval = 16;
     
     PhasesToolbar *phasesToolbar;
     QList<Player *> players;
@@ -28,7 +31,15 @@ private:
     QPointer<CardItem> hoveredCard;
     QBasicTimer *animationTimer;
     QSet<CardItem *> cardsToAnimate;
+    // Frame statistics of the current animation, reported when it ends
+    // if the program was started with --debug-output.
+    QElapsedTimer frameClock;
+    int animationFrames, droppedFrames;
+    qint64 animationTickTime;
+    bool reportFrameStats;
+    void stopAnimation();
     int playerRotation;
+    CardZone *getZoneAt(const QPointF &scenePos) const;
     void updateHover(const QPointF &scenePos);
 public:
     GameScene(PhasesToolbar *_phasesToolbar, QObject *parent = 0);
@@ -7,6 +7,7 @@
 #include <QDateTime>
 #include <QSettings>
 #include <QCryptographicHash>
+#include <QTimer>
 
 enum GameListColumn {ROOM, CREATED, DESCRIPTION, CREATOR, GAME_TYPE, RESTRICTIONS, PLAYERS, SPECTATORS};
 
@@ -39,9 +40,28 @@ const QString GamesModel::getGameCreatedString(const int secs) const {
 
 }
 
+GameFields::GameFields(const ServerInfo_Game &game)
+    : description(QString::fromStdString(game.description())),
+      creatorName(QString::fromStdString(game.creator_info().name())),
+      gameTypeMask(0),
+      largeGameTypes(false)
+{
+    for (int i = 0; i < game.game_types_size(); ++i) {
+        const quint64 bit = gameTypeBit(game.game_types(i));
+        if (bit)
+            gameTypeMask |= bit;
+        else
+            largeGameTypes = true;
+    }
+}
+
 GamesModel::GamesModel(const QMap<int, QString> &_rooms, const QMap<int, GameTypeMap> &_gameTypes, QObject *parent)
-    : QAbstractTableModel(parent), rooms(_rooms), gameTypes(_gameTypes)
+    : QAbstractTableModel(parent), rooms(_rooms), gameTypes(_gameTypes), firstChangedRow(-1), lastChangedRow(-1)
 {
+    dataChangedTimer = new QTimer(this);
+    dataChangedTimer->setSingleShot(true);
+    dataChangedTimer->setInterval(DATA_CHANGED_INTERVAL);
+    connect(dataChangedTimer, SIGNAL(timeout()), this, SLOT(emitDataChanged()));
 }
 
 QVariant GamesModel::data(const QModelIndex &index, int role) const
@@ -74,7 +94,7 @@ QVariant GamesModel::data(const QModelIndex &index, int role) const
             switch(role) {
             case SORT_ROLE:
             case Qt::DisplayRole:
-                return QString::fromStdString(g.description());
+                return gameFields[index.row()].description;
             case Qt::TextAlignmentRole:
                 return Qt::AlignLeft;
             default:
@@ -84,7 +104,7 @@ QVariant GamesModel::data(const QModelIndex &index, int role) const
             switch(role) {
             case SORT_ROLE:
             case Qt::DisplayRole:
-                return QString::fromStdString(g.creator_info().name());
+                return gameFields[index.row()].creatorName;
             case Qt::DecorationRole: {
                     QPixmap avatarPixmap = UserLevelPixmapGenerator::generatePixmap(13, (UserLevelFlags)g.creator_info().user_level(), false);
                     return QIcon(avatarPixmap);
@@ -199,31 +219,61 @@ const ServerInfo_Game &GamesModel::getGame(int row)
 
 void GamesModel::updateGameList(const ServerInfo_Game &game)
 {
-    for (int i = 0; i < gameList.size(); i++) {
-        if (gameList[i].game_id() == game.game_id()) {
-            if (game.closed()) {
-                beginRemoveRows(QModelIndex(), i, i);
-                gameList.removeAt(i);
-                endRemoveRows();
-            } else {
-                gameList[i].MergeFrom(game);
-                emit dataChanged(index(i, 0), index(i, NUM_COLS-1));
-            }
-            return;
+    QHash<int, int>::const_iterator it = gameRows.constFind(game.game_id());
+    if (it != gameRows.constEnd()) {
+        const int row = it.value();
+        if (game.closed()) {
+            // the pending rows must be reported before they move
+            emitDataChanged();
+
+            beginRemoveRows(QModelIndex(), row, row);
+            gameRows.remove(game.game_id());
+            gameList.removeAt(row);
+            gameFields.removeAt(row);
+            for (int i = row; i < gameList.size(); ++i)
+                gameRows[gameList[i].game_id()] = i;
+            endRemoveRows();
+        } else {
+            gameList[row].MergeFrom(game);
+            gameFields[row] = GameFields(gameList[row]);
+
+            if ((firstChangedRow == -1) || (row < firstChangedRow))
+                firstChangedRow = row;
+            if (row > lastChangedRow)
+                lastChangedRow = row;
+            if (!dataChangedTimer->isActive())
+                dataChangedTimer->start();
         }
+        return;
     }
     if (game.player_count() <= 0)
         return;
     beginInsertRows(QModelIndex(), gameList.size(), gameList.size());
+    gameRows.insert(game.game_id(), gameList.size());
     gameList.append(game);
+    gameFields.append(GameFields(game));
     endInsertRows();
 }
 
+void GamesModel::emitDataChanged()
+{
+    dataChangedTimer->stop();
+    if (firstChangedRow == -1)
+        return;
+
+    const int first = firstChangedRow;
+    const int last = lastChangedRow;
+    firstChangedRow = lastChangedRow = -1;
+    emit dataChanged(index(first, 0), index(last, NUM_COLS - 1));
+}
+
 GamesProxyModel::GamesProxyModel(QObject *parent, ServerInfo_User *_ownUser)
     : QSortFilterProxyModel(parent),
     ownUser(_ownUser),
     unavailableGamesVisible(false),
     showPasswordProtectedGames(true),
+    gameTypeFilterMask(0),
+    gameTypeFilterLarge(false),
     maxPlayersFilterMin(-1),
     maxPlayersFilterMax(-1)
 {
@@ -258,6 +308,7 @@ void GamesProxyModel::setCreatorNameFilter(const QString &_creatorNameFilter)
 void GamesProxyModel::setGameTypeFilter(const QSet<int> &_gameTypeFilter)
 {
     gameTypeFilter = _gameTypeFilter;
+    updateGameTypeFilterMask();
     invalidateFilter();
 }
 
@@ -275,6 +326,7 @@ void GamesProxyModel::resetFilterParameters()
     gameNameFilter = QString();
     creatorNameFilter = QString();
     gameTypeFilter.clear();
+    updateGameTypeFilterMask();
     maxPlayersFilterMin = 1;
     maxPlayersFilterMax = DEFAULT_MAX_PLAYERS_MAX;
 
@@ -299,6 +351,7 @@ void GamesProxyModel::loadFilterParameters(const QMap<int, QString> &allGameType
             gameTypeFilter.insert(gameTypesIterator.key());
         }
     }
+    updateGameTypeFilterMask();
 
     invalidateFilter();
 }
@@ -347,18 +400,24 @@ bool GamesProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &/*sourc
     }
     if (!showPasswordProtectedGames && game.with_password())
         return false;
+    const GameFields &fields = model->getGameFields(sourceRow);
     if (!gameNameFilter.isEmpty())
-        if (!QString::fromStdString(game.description()).contains(gameNameFilter, Qt::CaseInsensitive))
+        if (!fields.description.contains(gameNameFilter, Qt::CaseInsensitive))
             return false;
     if (!creatorNameFilter.isEmpty())
-        if (!QString::fromStdString(game.creator_info().name()).contains(creatorNameFilter, Qt::CaseInsensitive))
+        if (!fields.creatorName.contains(creatorNameFilter, Qt::CaseInsensitive))
             return false;
 
-    QSet<int> gameTypes;
-    for (int i = 0; i < game.game_types_size(); ++i)
-        gameTypes.insert(game.game_types(i));
-    if (!gameTypeFilter.isEmpty() && gameTypes.intersect(gameTypeFilter).isEmpty())
-        return false;
+    if (!gameTypeFilter.isEmpty() && !(fields.gameTypeMask & gameTypeFilterMask)) {
+        // only game type ids of 64 or more are left to be checked one by one
+        if (!gameTypeFilterLarge || !fields.largeGameTypes)
+            return false;
+        bool found = false;
+        for (int i = 0; !found && (i < game.game_types_size()); ++i)
+            found = gameTypeFilter.contains(game.game_types(i));
+        if (!found)
+            return false;
+    }
 
     if ((maxPlayersFilterMin != -1) && ((int)game.max_players() < maxPlayersFilterMin))
         return false;
@@ -368,6 +427,20 @@ bool GamesProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &/*sourc
     return true;
 }
 
+void GamesProxyModel::updateGameTypeFilterMask()
+{
+    gameTypeFilterMask = 0;
+    gameTypeFilterLarge = false;
+    QSetIterator<int> it(gameTypeFilter);
+    while (it.hasNext()) {
+        const quint64 bit = GameFields::gameTypeBit(it.next());
+        if (bit)
+            gameTypeFilterMask |= bit;
+        else
+            gameTypeFilterLarge = true;
+    }
+}
+
 QString GamesProxyModel::hashGameType(const QString &gameType) const {
     return QCryptographicHash::hash(gameType.toUtf8(), QCryptographicHash::Md5).toHex();
 }
@@ -3,23 +3,53 @@
 
 #include <QAbstractTableModel>
 #include <QSortFilterProxyModel>
+#include <QHash>
 #include <QList>
 #include <QSet>
 #include "gametypemap.h"
 #include "pb/serverinfo_game.pb.h"
 
 class ServerInfo_User;
+class QTimer;
+
+/*
+ * The fields of a game which are converted from the protobuf message once,
+ * when it changes, rather than every time the game is displayed or filtered.
+ */
+class GameFields {
+public:
+    QString description, creatorName;
+    // one bit per game type id below 64
+    quint64 gameTypeMask;
+    // the game has a game type id of 64 or more
+    bool largeGameTypes;
+
+    GameFields() : gameTypeMask(0), largeGameTypes(false) { }
+    GameFields(const ServerInfo_Game &game);
+    static quint64 gameTypeBit(int gameTypeId) { return ((gameTypeId >= 0) && (gameTypeId < 64)) ? ((quint64) 1 << gameTypeId) : 0; }
+};
 
 class GamesModel : public QAbstractTableModel {
     Q_OBJECT
 private:
     QList<ServerInfo_Game> gameList;
+    QList<GameFields> gameFields;
+    // game id -> row
+    QHash<int, int> gameRows;
     QMap<int, QString> rooms;
     QMap<int, GameTypeMap> gameTypes;
 
+    // The rows changed since the last dataChanged() signal. Updates arrive in
+    // bursts, so they are reported together once per frame.
+    QTimer *dataChangedTimer;
+    int firstChangedRow, lastChangedRow;
+
     static const int NUM_COLS = 8;
     static const int SECS_PER_MIN  = 60;
     static const int SECS_PER_HOUR = 3600;
+    static const int DATA_CHANGED_INTERVAL = 16;
+private slots:
+    void emitDataChanged();
 public:
     static const int SORT_ROLE = Qt::UserRole+1;
 
@@ -30,6 +60,7 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
     const QString getGameCreatedString(const int secs) const;
     const ServerInfo_Game &getGame(int row);
+    const GameFields &getGameFields(int row) const { return gameFields[row]; }
 
     /**
      * Update game list with a (possibly new) game.
@@ -50,6 +81,9 @@ private:
     bool showPasswordProtectedGames;
     QString gameNameFilter, creatorNameFilter;
     QSet<int> gameTypeFilter;
+    // gameTypeFilter as checked by filterAcceptsRow
+    quint64 gameTypeFilterMask;
+    bool gameTypeFilterLarge;
     int maxPlayersFilterMin, maxPlayersFilterMax;
 
     static const int DEFAULT_MAX_PLAYERS_MAX = 99;
@@ -59,6 +93,7 @@ private:
      * QSettings we just hash it.
      */
     QString hashGameType(const QString &gameType) const;
+    void updateGameTypeFilterMask();
 public:
     GamesProxyModel(QObject *parent = 0, ServerInfo_User *_ownUser = 0);
 
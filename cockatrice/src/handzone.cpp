@@ -1,4 +1,6 @@
 #include <QPainter>
+#include <QSet>
+#include "arrowitem.h"
 #include "handzone.h"
 #include "settingscache.h"
 #include "player.h"
@@ -83,9 +85,11 @@ void HandZone::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*optio
         painter->fillRect(boundingRect(), QBrush(bgPixmap));
 }
 
-void HandZone::reorganizeCards()
+void HandZone::reorganizeCardsImpl()
 {
     if (!cards.isEmpty()) {
+        QList<ArrowItem *> arrowsToUpdate;
+
         const int cardCount = cards.size();
         if (settingsCache->getHorizontalHand()) {
             bool leftJustified = settingsCache->getLeftJustified();
@@ -97,12 +101,18 @@ void HandZone::reorganizeCards()
                 CardItem *c = cards.at(i);
                 // If the total width of the cards is smaller than the available width,
                 // the cards do not need to overlap and are displayed in the center of the area.
+                QPointF newPos;
                 if (cardWidth * cardCount > totalWidth)
-                    c->setPos(xPadding + ((qreal) i) * (totalWidth - cardWidth) / (cardCount - 1), 5);
+                    newPos = QPointF(xPadding + ((qreal) i) * (totalWidth - cardWidth) / (cardCount - 1), 5);
                 else {
                     qreal xPosition = leftJustified ? xPadding + ((qreal) i) * cardWidth : 
                         xPadding + ((qreal) i) * cardWidth + (totalWidth - cardCount * cardWidth) / 2;
-                    c->setPos(xPosition, 5);
+                    newPos = QPointF(xPosition, 5);
+                }
+                if (c->pos() != newPos) {
+                    c->setPos(newPos);
+                    arrowsToUpdate.append(c->getArrowsFrom());
+                    arrowsToUpdate.append(c->getArrowsTo());
                 }
                 c->setRealZValue(i);
             }
@@ -120,13 +130,23 @@ void HandZone::reorganizeCards()
                 qreal x = i % 2 ? x2 : x1;
                 // If the total height of the cards is smaller than the available height,
                 // the cards do not need to overlap and are displayed in the center of the area.
+                QPointF newPos;
                 if (cardHeight * cardCount > totalHeight)
-                    c->setPos(x, ((qreal) i) * (totalHeight - cardHeight) / (cardCount - 1));
+                    newPos = QPointF(x, ((qreal) i) * (totalHeight - cardHeight) / (cardCount - 1));
                 else
-                    c->setPos(x, ((qreal) i) * cardHeight + (totalHeight - cardCount * cardHeight) / 2);
+                    newPos = QPointF(x, ((qreal) i) * cardHeight + (totalHeight - cardCount * cardHeight) / 2);
+                if (c->pos() != newPos) {
+                    c->setPos(newPos);
+                    arrowsToUpdate.append(c->getArrowsFrom());
+                    arrowsToUpdate.append(c->getArrowsTo());
+                }
                 c->setRealZValue(i);
             }
         }
+
+        QSetIterator<ArrowItem *> arrowIterator(QSet<ArrowItem *>::fromList(arrowsToUpdate));
+        while (arrowIterator.hasNext())
+            arrowIterator.next()->updatePath();
     }
     update();
 }
@@ -17,10 +17,10 @@ public:
     void handleDropEvent(const QList<CardDragItem *> &dragItems, CardZone *startZone, const QPoint &dropPoint);
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-    void reorganizeCards();
     void setWidth(qreal _width);
 protected:
     void addCardImpl(CardItem *card, int x, int y);
+    void reorganizeCardsImpl();
 };
 
 #endif
@@ -58,6 +58,7 @@ QString translationPath = TRANSLATION_PATH;
 #else
 QString translationPath = QString();
 #endif
+QString dataDir;
 
 #if QT_VERSION < 0x050000
 static void myMessageOutput(QtMsgType /*type*/, const char *msg)
@@ -141,13 +142,12 @@ int main(int argc, char *argv[])
     qsrand(QDateTime::currentDateTime().toTime_t());
     
 #if QT_VERSION < 0x050000
-    const QString dataDir = QDesktopServices::storageLocation(QDesktopServices::DataLocation);
+    dataDir = QDesktopServices::storageLocation(QDesktopServices::DataLocation);
 #else
-    const QString dataDir = QStandardPaths::standardLocations(QStandardPaths::DataLocation).first();
+    dataDir = QStandardPaths::standardLocations(QStandardPaths::DataLocation).first();
 #endif
-    if (!db->getLoadSuccess())
-        if (!db->loadCardDatabase(dataDir + "/cards.xml"))
-            settingsCache->setCardDatabasePath(dataDir + "/cards.xml");
+    // The card database keeps loading in the background; MainWindow checks the result
+    // (and falls back to the bundled cards.xml) once the load has finished.
     if (settingsCache->getTokenDatabasePath().isEmpty())
         settingsCache->setTokenDatabasePath(dataDir + "/tokens.xml");
     if (!QDir(settingsCache->getDeckPath()).exists() || settingsCache->getDeckPath().isEmpty()) {
@@ -164,14 +164,6 @@ int main(int argc, char *argv[])
     }
     if (!QDir().mkpath(settingsCache->getPicsPath() + "/CUSTOM"))
         qDebug() << "Could not create " + settingsCache->getPicsPath().toUtf8() + "/CUSTOM. Will fall back on default card images.";
-    if (QDir().mkpath(dataDir + "/customsets"))
-    {
-        // if the dir exists (or has just been created)
-        db->loadCustomCardDatabases(dataDir + "/customsets");
-    } else {
-        qDebug() << "Could not create " + dataDir + "/customsets folder.";
-    }
-
     if(settingsCache->getSoundPath().isEmpty() || !QDir(settingsCache->getSoundPath()).exists())
     {
         QDir tmpDir;
@@ -186,8 +178,8 @@ int main(int argc, char *argv[])
         settingsCache->setSoundPath(tmpDir.canonicalPath());
     }
 
-    if (!settingsValid() || db->getLoadStatus() != Ok) {
-        qDebug("main(): invalid settings or load status");
+    if (!settingsValid()) {
+        qDebug("main(): invalid settings");
         DlgSettings dlgSettings;
         dlgSettings.show();
         app.exec();
@@ -214,9 +206,7 @@ int main(int argc, char *argv[])
     delete db;
     delete settingsCache;
     delete rng;
-    PingPixmapGenerator::clear();
-    CountryPixmapGenerator::clear();
-    UserLevelPixmapGenerator::clear();
+    GeneratedPixmapCache::clear();
 
     return 0;
 }
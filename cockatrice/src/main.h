@@ -12,6 +12,7 @@ extern QSystemTrayIcon *trayIcon;
 extern QTranslator *translator;
 extern const QString translationPrefix;
 extern QString translationPath;
+extern QString dataDir;
 
 void installNewTranslator();
 
@@ -816,6 +816,8 @@ void MessageLogWidget::logSetActivePhase(int phase)
 
 void MessageLogWidget::containerProcessingStarted(const GameEventContext &_context)
 {
+    beginAppendBatch();
+
     if (_context.HasExtension(Context_MoveCard::ext))
         currentContext = MessageContext_MoveCard;
     else if (_context.HasExtension(Context_Mulligan::ext)) {
@@ -841,6 +843,7 @@ void MessageLogWidget::containerProcessingDone()
     }
     
     currentContext = MessageContext_None;
+    endAppendBatch();
 }
 
 void MessageLogWidget::connectToPlayer(Player *player)
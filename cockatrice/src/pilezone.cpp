@@ -74,7 +74,7 @@ void PileZone::handleDropEvent(const QList<CardDragItem *> &dragItems, CardZone
     player->sendGameCommand(cmd);
 }
 
-void PileZone::reorganizeCards()
+void PileZone::reorganizeCardsImpl()
 {
     update();
 }
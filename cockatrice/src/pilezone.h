@@ -11,7 +11,6 @@ public:
     PileZone(Player *_p, const QString &_name, bool _isShufflable, bool _contentsKnown, QGraphicsItem *parent = 0);
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-    void reorganizeCards();
     void handleDropEvent(const QList<CardDragItem *> &dragItems, CardZone *startZone, const QPoint &dropPoint);
 protected:
     void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -19,6 +18,7 @@ protected:
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
     void hoverEnterEvent(QGraphicsSceneHoverEvent *event);
     void addCardImpl(CardItem *card, int x, int y);
+    void reorganizeCardsImpl();
 };
 
 #endif
@@ -1,6 +1,8 @@
 #include "pixmapgenerator.h"
 #include "pb/serverinfo_user.pb.h"
 #include <QPainter>
+#include <QCache>
+#include <QHash>
 #include <QSvgRenderer>
 #include <cmath>
 #ifdef _WIN32
@@ -8,33 +10,77 @@
 #endif /* _WIN32 */
 #include <QDebug>
 
-QMap<QString, QPixmap> PhasePixmapGenerator::pmCache;
+enum PixmapGenerator { PhaseGenerator, CounterGenerator, PingGenerator, GenderGenerator, CountryGenerator, UserLevelGenerator, LockGenerator };
+
+// in kilobytes, which is the unit of the costs
+static const int generatedPixmapBudget = 4096;
+
+static QCache<quint64, QPixmap> generatedPixmaps(generatedPixmapBudget);
+// small numbers for the phase and counter names, which are part of the keys
+static QHash<QString, int> pixmapNameIds;
+
+// The generator in the top 4 bits, the size in the next 16, and the variant in the lower 44.
+static quint64 pixmapKey(PixmapGenerator generator, int size, quint64 variant)
+{
+    return ((quint64) generator << 60) | ((quint64) (size & 0xffff) << 44) | (variant & Q_UINT64_C(0xfffffffffff));
+}
+
+static quint64 pixmapNameId(const QString &name)
+{
+    QHash<QString, int>::const_iterator it = pixmapNameIds.constFind(name);
+    if (it != pixmapNameIds.constEnd())
+        return it.value();
+
+    const int id = pixmapNameIds.size();
+    pixmapNameIds.insert(name, id);
+    return id;
+}
+
+static bool findCachedPixmap(quint64 key, QPixmap &pixmap)
+{
+    QPixmap *cachedPixmap = generatedPixmaps.object(key);
+    if (!cachedPixmap)
+        return false;
+    pixmap = *cachedPixmap;
+    return true;
+}
+
+static void insertCachedPixmap(quint64 key, const QPixmap &pixmap)
+{
+    generatedPixmaps.insert(key, new QPixmap(pixmap), qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024));
+}
+
+void GeneratedPixmapCache::clear()
+{
+    generatedPixmaps.clear();
+}
 
 QPixmap PhasePixmapGenerator::generatePixmap(int height, QString name)
 {
-    QString key = name + QString::number(height);
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = pixmapKey(PhaseGenerator, height, pixmapNameId(name));
+    QPixmap pixmap;
+    if (findCachedPixmap(key, pixmap))
+        return pixmap;
     
     QSvgRenderer svg(QString(":/resources/phases/icon_phase_" + name + ".svg"));
     
-    QPixmap pixmap(height, height);
+    pixmap = QPixmap(height, height);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     svg.render(&painter, QRectF(0, 0, height, height));
-    pmCache.insert(key, pixmap);
+    insertCachedPixmap(key, pixmap);
     return pixmap;
 }
 
-QMap<QString, QPixmap> CounterPixmapGenerator::pmCache;
-
 QPixmap CounterPixmapGenerator::generatePixmap(int height, QString name, bool highlight)
 {
+    const quint64 key = pixmapKey(CounterGenerator, height, (pixmapNameId(name) << 1) | (highlight ? 1 : 0));
+    QPixmap pixmap;
+    if (findCachedPixmap(key, pixmap))
+        return pixmap;
+
     if (highlight)
         name.append("_highlight");
-    QString key = name + QString::number(height);
-    if (pmCache.contains(key))
-        return pmCache.value(key);
     
     QSvgRenderer svg(QString(":/resources/counters/" + name + ".svg"));
     
@@ -46,21 +92,23 @@ QPixmap CounterPixmapGenerator::generatePixmap(int height, QString name, bool hi
     }
     
     int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-    QPixmap pixmap(width, height);
+    pixmap = QPixmap(width, height);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     svg.render(&painter, QRectF(0, 0, width, height));
-    pmCache.insert(key, pixmap);
+    insertCachedPixmap(key, pixmap);
     return pixmap;
 }
 
 QPixmap PingPixmapGenerator::generatePixmap(int size, int value, int max)
 {
-    int key = size * 1000000 + max * 1000 + value;
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    // -1 stands for an unknown ping, so both are offset by one
+    const quint64 key = pixmapKey(PingGenerator, size, ((quint64) ((value + 1) & 0xfffff) << 20) | (quint64) ((max + 1) & 0xfffff));
+    QPixmap pixmap;
+    if (findCachedPixmap(key, pixmap))
+        return pixmap;
     
-    QPixmap pixmap(size, size);
+    pixmap = QPixmap(size, size);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     QColor color;
@@ -74,22 +122,21 @@ QPixmap PingPixmapGenerator::generatePixmap(int size, int value, int max)
     g.setColorAt(1, Qt::transparent);
     painter.fillRect(0, 0, pixmap.width(), pixmap.height(), QBrush(g));
     
-    pmCache.insert(key, pixmap);
+    insertCachedPixmap(key, pixmap);
 
     return pixmap;
 }
 
-QMap<int, QPixmap> PingPixmapGenerator::pmCache;
-
 QPixmap GenderPixmapGenerator::generatePixmap(int height, int _gender)
 {
     ServerInfo_User::Gender gender = static_cast<ServerInfo_User::Gender>(_gender);
     if ((gender != ServerInfo_User::Male) && (gender != ServerInfo_User::Female))
         gender = ServerInfo_User::GenderUnknown;
     
-    int key = gender * 100000 + height;
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = pixmapKey(GenderGenerator, height, gender);
+    QPixmap pixmap;
+    if (findCachedPixmap(key, pixmap))
+        return pixmap;
     
     QString genderStr;
     switch (gender) {
@@ -100,46 +147,43 @@ QPixmap GenderPixmapGenerator::generatePixmap(int height, int _gender)
     
     QSvgRenderer svg(QString(":/resources/genders/" + genderStr + ".svg"));
     int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-    QPixmap pixmap(width, height);
+    pixmap = QPixmap(width, height);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     svg.render(&painter, QRectF(0, 0, width, height));
     
-    pmCache.insert(key, pixmap);
+    insertCachedPixmap(key, pixmap);
     return pixmap;
 }
 
-QMap<int, QPixmap> GenderPixmapGenerator::pmCache;
-
 QPixmap CountryPixmapGenerator::generatePixmap(int height, const QString &countryCode)
 {
     if (countryCode.size() != 2)
         return QPixmap();
-    QString key = countryCode + QString::number(height);
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = pixmapKey(CountryGenerator, height, ((quint64) countryCode[0].unicode() << 16) | countryCode[1].unicode());
+    QPixmap pixmap;
+    if (findCachedPixmap(key, pixmap))
+        return pixmap;
     
     QSvgRenderer svg(QString(":/resources/countries/" + countryCode + ".svg"));
     int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-    QPixmap pixmap(width, height);
+    pixmap = QPixmap(width, height);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     svg.render(&painter, QRectF(0, 0, width, height));
     painter.setPen(Qt::black);
     painter.drawRect(0, 0, width - 1, height - 1);
     
-    pmCache.insert(key, pixmap);
+    insertCachedPixmap(key, pixmap);
     return pixmap;
 }
 
-QMap<QString, QPixmap> CountryPixmapGenerator::pmCache;
-
 QPixmap UserLevelPixmapGenerator::generatePixmap(int height, UserLevelFlags userLevel, bool isBuddy)
 {
-
-    int key = height * 10000 + (int) userLevel + (int) isBuddy;
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = pixmapKey(UserLevelGenerator, height, ((quint64) (int) userLevel << 1) | (isBuddy ? 1 : 0));
+    QPixmap pixmap;
+    if (findCachedPixmap(key, pixmap))
+        return pixmap;
 
     QString levelString;
     if (userLevel.testFlag(ServerInfo_User::IsAdmin))
@@ -156,34 +200,29 @@ QPixmap UserLevelPixmapGenerator::generatePixmap(int height, UserLevelFlags user
 
     QSvgRenderer svg(QString(":/resources/userlevels/" + levelString + ".svg"));
     int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-    QPixmap pixmap(width, height);
+    pixmap = QPixmap(width, height);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     svg.render(&painter, QRectF(0, 0, width, height));
 
-    pmCache.insert(key, pixmap);
+    insertCachedPixmap(key, pixmap);
     return pixmap;
 }
 
-QMap<int, QPixmap> UserLevelPixmapGenerator::pmCache;
-
-
 QPixmap LockPixmapGenerator::generatePixmap(int height)
 {
-
-    int key = height;
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = pixmapKey(LockGenerator, height, 0);
+    QPixmap pixmap;
+    if (findCachedPixmap(key, pixmap))
+        return pixmap;
 
     QSvgRenderer svg(QString(":/resources/lock.svg"));
     int width = (int) round(height * (double) svg.defaultSize().width() / (double) svg.defaultSize().height());
-    QPixmap pixmap(width, height);
+    pixmap = QPixmap(width, height);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     svg.render(&painter, QRectF(0, 0, width, height));
 
-    pmCache.insert(key, pixmap);
+    insertCachedPixmap(key, pixmap);
     return pixmap;
 }
-
-QMap<int, QPixmap> LockPixmapGenerator::pmCache;
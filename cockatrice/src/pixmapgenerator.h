@@ -2,64 +2,49 @@
 #define PIXMAPGENERATOR_H
 
 #include <QPixmap>
-#include <QMap>
 
 #include "user_level.h"
 
+// The pixmaps of all generators are kept in one cache with a fixed budget,
+// which evicts the least recently used ones when it is full.
+class GeneratedPixmapCache {
+public:
+    static void clear();
+};
+
 class PhasePixmapGenerator {
-private:
-    static QMap<QString, QPixmap> pmCache;
 public:
     static QPixmap generatePixmap(int size, QString name);
-    static void clear() { pmCache.clear(); }
 };
 
 class CounterPixmapGenerator {
-private:
-    static QMap<QString, QPixmap> pmCache;
 public:
     static QPixmap generatePixmap(int size, QString name, bool highlight);
-    static void clear() { pmCache.clear(); }
 };
 
 class PingPixmapGenerator {
-private:
-    static QMap<int, QPixmap> pmCache;
 public:
     static QPixmap generatePixmap(int size, int value, int max);
-    static void clear() { pmCache.clear(); }
 };
 
 class GenderPixmapGenerator {
-private:
-    static QMap<int, QPixmap> pmCache;
 public:
     static QPixmap generatePixmap(int height, int gender);
-    static void clear() { pmCache.clear(); }
 };
 
 class CountryPixmapGenerator {
-private:
-    static QMap<QString, QPixmap> pmCache;
 public:
     static QPixmap generatePixmap(int height, const QString &countryCode);
-    static void clear() { pmCache.clear(); }
 };
 
 class UserLevelPixmapGenerator {
-private:
-    static QMap<int, QPixmap> pmCache;
 public:
     static QPixmap generatePixmap(int height, UserLevelFlags userLevel, bool isBuddy);
-    static void clear() { pmCache.clear(); }
 };
 
 class LockPixmapGenerator {
-private:
-    static QMap<int, QPixmap> pmCache;
 public:
     static QPixmap generatePixmap(int height);
-    static void clear() { pmCache.clear(); }
 };
 
 #endif
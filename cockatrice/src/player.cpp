@@ -1327,7 +1327,7 @@ void Player::eventMoveCard(const Event_MoveCard &event, const GameEventContext &
     if (card->getAttachedTo() && (startZone != targetZone)) {
         CardItem *parentCard = card->getAttachedTo();
         card->setAttachedTo(0);
-        parentCard->getZone()->reorganizeCards();
+        parentCard->getZone()->reorganizeCardsFor(parentCard);
     }
 
     card->deleteDragItem();
@@ -1366,9 +1366,11 @@ void Player::eventMoveCard(const Event_MoveCard &event, const GameEventContext &
         while (arrowIterator.hasNext()) {
             ArrowItem *arrow = arrowIterator.next().value();
             if ((arrow->getStartItem() == card) || (arrow->getTargetItem() == card)) {
-                if (startZone == targetZone)
-                    arrow->updatePath();
-                else
+                if (startZone == targetZone) {
+                    // a deferred layout updates the arrows when the zone is laid out
+                    if (!CardZone::isLayoutDeferred())
+                        arrow->updatePath();
+                } else
                     arrowsToDelete.append(arrow);
             }
         }
@@ -1436,11 +1438,11 @@ void Player::eventAttachCard(const Event_AttachCard &event)
     
     startCard->setAttachedTo(targetCard);
     
-    startZone->reorganizeCards();
-    if ((startZone != targetZone) && targetZone)
-        targetZone->reorganizeCards();
+    startZone->reorganizeCardsFor(startCard);
+    if ((startZone != targetZone) && targetCard)
+        targetZone->reorganizeCardsFor(targetCard);
     if (oldParent)
-        oldParent->getZone()->reorganizeCards();
+        oldParent->getZone()->reorganizeCardsFor(oldParent);
     
     if (targetCard)
         emit logAttachCard(this, startCard->getName(), targetPlayer, targetCard->getName());
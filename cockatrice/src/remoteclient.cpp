@@ -16,6 +16,7 @@ static const unsigned int protocolVersion = 14;
 RemoteClient::RemoteClient(QObject *parent)
     : AbstractClient(parent), timeRunning(0), lastDataReceived(0), messageInProgress(false), handshakeStarted(false), messageLength(0)
 {
+    batchEvents = true;
     timer = new QTimer(this);
     timer->setInterval(1000);
     connect(timer, SIGNAL(timeout()), this, SLOT(ping()));
@@ -198,10 +199,10 @@ void RemoteClient::readData()
                     messageInProgress = true;
                 }
             } else
-                return;
+                break;
         }
         if (inputBuffer.size() < messageLength)
-            return;
+            break;
         
         ServerMessage newServerMessage;
         newServerMessage.ParseFromArray(inputBuffer.data(), messageLength);
@@ -211,11 +212,16 @@ void RemoteClient::readData()
         inputBuffer.remove(0, messageLength);
         messageInProgress = false;
         
-        processProtocolItem(newServerMessage);
+        processOwnedProtocolItem(newServerMessage);
     
-        if (getStatus() == StatusDisconnecting) // use thread-safe getter
+        if (getStatus() == StatusDisconnecting) { // use thread-safe getter
+            flushEventBatch();
             doDisconnectFromServer();
+        }
     } while (!inputBuffer.isEmpty());
+
+    // hand all events read at once to the GUI thread together
+    flushEventBatch();
 }
 
 void RemoteClient::sendCommandContainer(const CommandContainer &cont)
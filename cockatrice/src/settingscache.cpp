@@ -96,6 +96,7 @@ void SettingsCache::setCardInfoViewMode(const int _viewMode) {
 void SettingsCache::setHighlightWords(const QString &_highlightWords) {
     highlightWords = _highlightWords;
     settings->setValue("personal/highlightWords", highlightWords);
+    emit highlightWordsChanged();
 }
 
 void SettingsCache::setMasterVolume(int _masterVolume) {
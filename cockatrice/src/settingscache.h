@@ -42,6 +42,7 @@ signals:
     void ignoreUnregisteredUserMessagesChanged();
     void pixmapCacheSizeChanged(int newSizeInMBs);
     void masterVolumeChanged(int value);
+    void highlightWordsChanged();
 private:
     QSettings *settings;
 
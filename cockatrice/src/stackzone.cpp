@@ -73,7 +73,7 @@ void StackZone::handleDropEvent(const QList<CardDragItem *> &dragItems, CardZone
     player->sendGameCommand(cmd);
 }
 
-void StackZone::reorganizeCards()
+void StackZone::reorganizeCardsImpl()
 {
     if (!cards.isEmpty()) {
         QList<ArrowItem *> arrowsToUpdate;
@@ -92,14 +92,18 @@ void StackZone::reorganizeCards()
             qreal x = i % 2 ? x2 : x1;
             // If the total height of the cards is smaller than the available height,
             // the cards do not need to overlap and are displayed in the center of the area.
+            QPointF newPos;
             if (cardHeight * cardCount > totalHeight)
-                c->setPos(x, ((qreal) i) * (totalHeight - cardHeight) / (cardCount - 1));
+                newPos = QPointF(x, ((qreal) i) * (totalHeight - cardHeight) / (cardCount - 1));
             else
-                c->setPos(x, ((qreal) i) * cardHeight + (totalHeight - cardCount * cardHeight) / 2);
+                newPos = QPointF(x, ((qreal) i) * cardHeight + (totalHeight - cardCount * cardHeight) / 2);
             c->setRealZValue(i);
             
-            arrowsToUpdate.append(c->getArrowsFrom());
-            arrowsToUpdate.append(c->getArrowsTo());
+            if (c->pos() != newPos) {
+                c->setPos(newPos);
+                arrowsToUpdate.append(c->getArrowsFrom());
+                arrowsToUpdate.append(c->getArrowsTo());
+            }
         }
         QSetIterator<ArrowItem *> arrowIterator(QSet<ArrowItem *>::fromList(arrowsToUpdate));
         while (arrowIterator.hasNext())
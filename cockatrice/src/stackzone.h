@@ -15,9 +15,9 @@ public:
     void handleDropEvent(const QList<CardDragItem *> &dragItems, CardZone *startZone, const QPoint &dropPoint);
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-    void reorganizeCards();
 protected:
     void addCardImpl(CardItem *card, int x, int y);
+    void reorganizeCardsImpl();
 };
 
 #endif
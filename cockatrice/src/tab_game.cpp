@@ -771,6 +771,8 @@ void TabGame::processGameEventContainer(const GameEventContainer &cont, Abstract
 {
     const GameEventContext &context = cont.context();
     messageLog->containerProcessingStarted(context);
+    // the zones are laid out once for the whole container
+    CardZone::beginDeferredLayout();
     const int eventListSize = cont.event_list_size();
     for (int i = 0; i < eventListSize; ++i) {
         const GameEvent &event = cont.event_list(i);
@@ -813,6 +815,7 @@ void TabGame::processGameEventContainer(const GameEventContainer &cont, Abstract
             }
         }
     }
+    CardZone::endDeferredLayout();
     messageLog->containerProcessingDone();
 }
 
@@ -102,10 +102,11 @@ TabRoom::TabRoom(TabSupervisor *_tabSupervisor, AbstractClient *_client, ServerI
     retranslateUi();
     setLayout(hbox);
 
+    userList->beginBulkUpdate();
     const int userListSize = info.user_list_size();
     for (int i = 0; i < userListSize; ++i)
         userList->processUserInfo(info.user_list(i), true);
-    userList->sortItems();
+    userList->endBulkUpdate();
 
     const int gameListSize = info.game_list_size();
     for (int i = 0; i < gameListSize; ++i)
@@ -221,7 +222,6 @@ void TabRoom::processListGamesEvent(const Event_ListGames &event)
 void TabRoom::processJoinRoomEvent(const Event_JoinRoom &event)
 {
     userList->processUserInfo(event.user_info(), true);
-    userList->sortItems();
 }
 
 void TabRoom::processLeaveRoomEvent(const Event_LeaveRoom &event)
@@ -232,12 +232,12 @@ void TabRoom::processLeaveRoomEvent(const Event_LeaveRoom &event)
 void TabRoom::processRoomSayEvent(const Event_RoomSay &event)
 {
     QString senderName = QString::fromStdString(event.name());
-    if (tabSupervisor->getUserListsTab()->getIgnoreList()->getUsers().contains(senderName))
+    const UserDirectory &userDirectory = tabSupervisor->getUserListsTab()->getUserDirectory();
+    if (userDirectory.isIgnored(senderName))
         return;
-    UserListTWI *twi = userList->getUsers().value(senderName);
     UserLevelFlags userLevel;
-    if (twi) {
-        userLevel = UserLevelFlags(twi->getUserInfo().user_level());
+    if (userDirectory.isOnline(senderName)) {
+        userLevel = userDirectory.getUserLevel(senderName);
         if (settingsCache->getIgnoreUnregisteredUsers() && !userLevel.testFlag(ServerInfo_User::IsRegistered))
             return;
     }
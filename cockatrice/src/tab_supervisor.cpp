@@ -20,6 +20,7 @@
 #include "pb/room_commands.pb.h"
 #include "pb/room_event.pb.h"
 #include "pb/game_event_container.pb.h"
+#include "pb/server_message.pb.h"
 #include "pb/event_user_message.pb.h"
 #include "pb/event_game_joined.pb.h"
 #include "pb/serverinfo_user.pb.h"
@@ -77,7 +78,7 @@ void CloseButton::paintEvent(QPaintEvent * /*event*/)
 }
 
 TabSupervisor::TabSupervisor(AbstractClient *_client, QWidget *parent)
-    : QTabWidget(parent), userInfo(0), client(_client), tabServer(0), tabUserLists(0), tabDeckStorage(0), tabReplays(0), tabAdmin(0)
+    : QTabWidget(parent), userInfo(0), client(_client), tabServer(0), tabUserLists(0), tabDeckStorage(0), tabReplays(0), tabAdmin(0), processingEvents(false)
 {
     tabChangedIcon = new QIcon(":/resources/icon_tab_changed.svg");
     setElideMode(Qt::ElideRight);
@@ -87,6 +88,7 @@ TabSupervisor::TabSupervisor(AbstractClient *_client, QWidget *parent)
 
     connect(client, SIGNAL(roomEventReceived(const RoomEvent &)), this, SLOT(processRoomEvent(const RoomEvent &)));
     connect(client, SIGNAL(gameEventContainerReceived(const GameEventContainer &)), this, SLOT(processGameEventContainer(const GameEventContainer &)));
+    connect(client, SIGNAL(eventBatchReceived(const QList<ServerMessage> &)), this, SLOT(processEventBatch(const QList<ServerMessage> &)));
     connect(client, SIGNAL(gameJoinedEventReceived(const Event_GameJoined &)), this, SLOT(gameJoined(const Event_GameJoined &)));
     connect(client, SIGNAL(userMessageEventReceived(const Event_UserMessage &)), this, SLOT(processUserMessageEvent(const Event_UserMessage &)));
     connect(client, SIGNAL(maxPingTime(int, int)), this, SLOT(updatePingTime(int, int)));
@@ -503,6 +505,27 @@ void TabSupervisor::processGameEventContainer(const GameEventContainer &cont)
         qDebug() << "gameEvent: invalid gameId";
 }
 
+void TabSupervisor::processEventBatch(const QList<ServerMessage> &batch)
+{
+    // A modal dialog opened by one of the events runs a nested event loop, which
+    // can deliver the next batch. That batch is only queued behind the current
+    // one here, so the events are still processed in the order they arrived.
+    pendingEvents += batch;
+    if (processingEvents)
+        return;
+
+    processingEvents = true;
+    for (int i = 0; i < pendingEvents.size(); ++i) {
+        const ServerMessage &item = pendingEvents.at(i);
+        if (item.message_type() == ServerMessage::ROOM_EVENT)
+            processRoomEvent(item.room_event());
+        else
+            processGameEventContainer(item.game_event_container());
+    }
+    pendingEvents.clear();
+    processingEvents = false;
+}
+
 void TabSupervisor::processUserMessageEvent(const Event_UserMessage &event)
 {
     QString senderName = QString::fromStdString(event.sender_name());
@@ -510,9 +533,9 @@ void TabSupervisor::processUserMessageEvent(const Event_UserMessage &event)
     if (!tab)
         tab = messageTabs.value(QString::fromStdString(event.receiver_name()));
     if (!tab) {
-        UserListTWI *twi = tabUserLists->getAllUsersList()->getUsers().value(senderName);
-        if (twi) {
-            UserLevelFlags userLevel = UserLevelFlags(twi->getUserInfo().user_level());
+        const UserDirectory &userDirectory = tabUserLists->getUserDirectory();
+        if (userDirectory.isOnline(senderName)) {
+            UserLevelFlags userLevel = userDirectory.getUserLevel(senderName);
             if (settingsCache->getIgnoreUnregisteredUserMessages() &&
                 !userLevel.testFlag(ServerInfo_User::IsRegistered))
                 // Flags are additive, so reg/mod/admin are all IsRegistered
@@ -5,6 +5,7 @@
 #include <QMap>
 #include <QAbstractButton>
 #include "deck_loader.h"
+#include "pb/server_message.pb.h"
 
 class QMenu;
 class AbstractClient;
@@ -56,6 +57,9 @@ private:
     QList<TabGame *> replayTabs;
     QMap<QString, TabMessage *> messageTabs;
     QList<TabDeckEditor *> deckEditorTabs;
+    // Event batches not processed yet, in the order they arrived.
+    QList<ServerMessage> pendingEvents;
+    bool processingEvents;
     int myAddTab(Tab *tab);
     void addCloseButtonToTab(Tab *tab, int tabIndex);
     QString sanitizeTabName(QString dirty) const;
@@ -104,6 +108,7 @@ private slots:
     void updateTabText(Tab *tab, const QString &newTabText);
     void processRoomEvent(const RoomEvent &event);
     void processGameEventContainer(const GameEventContainer &cont);
+    void processEventBatch(const QList<ServerMessage> &batch);
     void processUserMessageEvent(const Event_UserMessage &event);
 };
 
@@ -119,18 +119,23 @@ void TabUserLists::processListUsersResponse(const Response &response)
 {
     const Response_ListUsers &resp = response.GetExtension(Response_ListUsers::ext);
     
+    allUsersList->beginBulkUpdate();
+    ignoreList->beginBulkUpdate();
+    buddyList->beginBulkUpdate();
+
     const int userListSize = resp.user_list_size();
     for (int i = 0; i < userListSize; ++i) {
         const ServerInfo_User &info = resp.user_list(i);
         const QString userName = QString::fromStdString(info.name());
+        userDirectory.setUserOnline(info);
         allUsersList->processUserInfo(info, true);
         ignoreList->setUserOnline(userName, true);
         buddyList->setUserOnline(userName, true);
     }
     
-    allUsersList->sortItems();
-    ignoreList->sortItems();
-    buddyList->sortItems();
+    allUsersList->endBulkUpdate();
+    ignoreList->endBulkUpdate();
+    buddyList->endBulkUpdate();
 }
 
 void TabUserLists::processUserJoinedEvent(const Event_UserJoined &event)
@@ -138,14 +143,11 @@ void TabUserLists::processUserJoinedEvent(const Event_UserJoined &event)
     const ServerInfo_User &info = event.user_info();
     const QString userName = QString::fromStdString(info.name());
     
+    userDirectory.setUserOnline(info);
     allUsersList->processUserInfo(info, true);
     ignoreList->setUserOnline(userName, true);
     buddyList->setUserOnline(userName, true);
     
-    allUsersList->sortItems();
-    ignoreList->sortItems();
-    buddyList->sortItems();
-    
     emit userJoined(info);
 }
 
@@ -153,10 +155,9 @@ void TabUserLists::processUserLeftEvent(const Event_UserLeft &event)
 {
     QString userName = QString::fromStdString(event.name());
     if (allUsersList->deleteUser(userName)) {
+        userDirectory.setUserOffline(userName);
         ignoreList->setUserOnline(userName, false);
         buddyList->setUserOnline(userName, false);
-        ignoreList->sortItems();
-        buddyList->sortItems();
         
         emit userLeft(userName);
     }
@@ -164,33 +165,42 @@ void TabUserLists::processUserLeftEvent(const Event_UserLeft &event)
 
 void TabUserLists::buddyListReceived(const QList<ServerInfo_User> &_buddyList)
 {
-    for (int i = 0; i < _buddyList.size(); ++i)
+    buddyList->beginBulkUpdate();
+    for (int i = 0; i < _buddyList.size(); ++i) {
+        userDirectory.setBuddy(QString::fromStdString(_buddyList[i].name()), true);
         buddyList->processUserInfo(_buddyList[i], false);
-    buddyList->sortItems();
+    }
+    buddyList->endBulkUpdate();
 }
 
 void TabUserLists::ignoreListReceived(const QList<ServerInfo_User> &_ignoreList)
 {
-    for (int i = 0; i < _ignoreList.size(); ++i)
+    ignoreList->beginBulkUpdate();
+    for (int i = 0; i < _ignoreList.size(); ++i) {
+        userDirectory.setIgnored(QString::fromStdString(_ignoreList[i].name()), true);
         ignoreList->processUserInfo(_ignoreList[i], false);
-    ignoreList->sortItems();
+    }
+    ignoreList->endBulkUpdate();
 }
 
 void TabUserLists::processAddToListEvent(const Event_AddToList &event)
 {
     const ServerInfo_User &info = event.user_info();
-    bool online = allUsersList->getUsers().contains(QString::fromStdString(info.name()));
+    const QString userName = QString::fromStdString(info.name());
+    bool online = userDirectory.isOnline(userName);
     QString list = QString::fromStdString(event.list_name());
     UserList *userList = 0;
-    if (list == "buddy")
+    if (list == "buddy") {
         userList = buddyList;
-    else if (list == "ignore")
+        userDirectory.setBuddy(userName, true);
+    } else if (list == "ignore") {
         userList = ignoreList;
+        userDirectory.setIgnored(userName, true);
+    }
     if (!userList)
         return;
     
     userList->processUserInfo(info, online);
-    userList->sortItems();
 }
 
 void TabUserLists::processRemoveFromListEvent(const Event_RemoveFromList &event)
@@ -198,10 +208,13 @@ void TabUserLists::processRemoveFromListEvent(const Event_RemoveFromList &event)
     QString list = QString::fromStdString(event.list_name());
     QString user = QString::fromStdString(event.user_name());
     UserList *userList = 0;
-    if (list == "buddy")
+    if (list == "buddy") {
         userList = buddyList;
-    else if (list == "ignore")
+        userDirectory.setBuddy(user, false);
+    } else if (list == "ignore") {
         userList = ignoreList;
+        userDirectory.setIgnored(user, false);
+    }
     if (!userList)
         return;
     userList->deleteUser(user);
@@ -3,6 +3,7 @@
 
 #include "tab.h"
 #include "pb/serverinfo_user.pb.h"
+#include "userdirectory.h"
 #include <QLineEdit>
 
 class AbstractClient;
@@ -38,6 +39,7 @@ private:
     UserList *allUsersList;
     UserList *buddyList;
     UserList *ignoreList;
+    UserDirectory userDirectory;
     UserInfoBox *userInfoBox;
     QLineEdit *addBuddyEdit;
     QLineEdit *addIgnoreEdit;
@@ -49,6 +51,7 @@ public:
     const UserList *getAllUsersList() const { return allUsersList; }
     const UserList *getBuddyList() const { return buddyList; }
     const UserList *getIgnoreList() const { return ignoreList; }
+    const UserDirectory &getUserDirectory() const { return userDirectory; }
 };
 
 #endif
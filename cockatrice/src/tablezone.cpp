@@ -24,7 +24,7 @@ const QColor TableZone::GRADIENT_COLORLESS  = QColor(255, 255, 255, 0);
 
 
 TableZone::TableZone(Player *_p, QGraphicsItem *parent)
-    : SelectZone(_p, "table", true, false, true, parent), active(false)
+    : SelectZone(_p, "table", true, false, true, parent), active(false), dirtyRows(0), allRowsDirty(true)
 {
     connect(settingsCache, SIGNAL(tableBgPathChanged()), this, SLOT(updateBgPixmap()));
     connect(settingsCache, SIGNAL(invertVerticalCoordinateChanged()), this, SLOT(reorganizeCards()));
@@ -161,36 +161,83 @@ void TableZone::handleDropEventByGrid(const QList<CardDragItem *> &dragItems, Ca
 }
 
 
-void TableZone::reorganizeCards()
+void TableZone::invalidateRow(int row)
 {
+    if ((row >= 0) && (row < TABLEROWS))
+        dirtyRows |= 1 << row;
+    else
+        allRowsDirty = true;
+}
+
+
+void TableZone::invalidateLayout(CardItem *changedCard)
+{
+    if (!changedCard) {
+        allRowsDirty = true;
+        return;
+    }
+
+    // A card which leaves its grid point or is attached to another card
+    // changes both its own row and the row of that card.
+    invalidateRow(changedCard->getGridPos().y());
+    CardItem *attachedTo = changedCard->getAttachedTo();
+    if (attachedTo && (attachedTo->getZone() == this))
+        invalidateRow(attachedTo->getGridPos().y());
+}
+
+
+void TableZone::reorganizeCardsImpl()
+{
+    const bool allRows = allRowsDirty;
+    const int rows = dirtyRows;
+    allRowsDirty = false;
+    dirtyRows = 0;
+    if (!allRows && !rows)
+        return;
+
     QList<ArrowItem *> arrowsToUpdate;
+    QList<CardItem *> rowCards;
+    for (int i = 0; i < cards.size(); ++i) {
+        const int y = cards[i]->getGridPos().y();
+        if (allRows || ((y >= 0) && (y < TABLEROWS) && (rows & (1 << y))))
+            rowCards.append(cards[i]);
+    }
     
     // Calculate table grid distortion so that the mapping functions work properly
+    if (allRows)
+        gridPointWidth.clear();
+    else
+        for (int row = 0; row < TABLEROWS; ++row)
+            if (rows & (1 << row)) {
+                QMap<int, int>::iterator it = gridPointWidth.lowerBound(row * 1000);
+                while ((it != gridPointWidth.end()) && (it.key() < (row + 1) * 1000))
+                    it = gridPointWidth.erase(it);
+            }
+
     QMap<int, int> gridPointStackCount;
-    for (int i = 0; i < cards.size(); ++i) {
-        const QPoint &gridPoint = cards[i]->getGridPos();
+    for (int i = 0; i < rowCards.size(); ++i) {
+        const QPoint &gridPoint = rowCards[i]->getGridPos();
         if (gridPoint.x() == -1)
             continue;
         
         const int key = gridPoint.x() / 3 + gridPoint.y() * 1000;
         gridPointStackCount.insert(key, gridPointStackCount.value(key, 0) + 1);
     }
-    gridPointWidth.clear();
-    for (int i = 0; i < cards.size(); ++i) {
-        const QPoint &gridPoint = cards[i]->getGridPos();
+    for (int i = 0; i < rowCards.size(); ++i) {
+        const QPoint &gridPoint = rowCards[i]->getGridPos();
         if (gridPoint.x() == -1)
             continue;
         
         const int key = gridPoint.x() / 3 + gridPoint.y() * 1000;
         const int stackCount = gridPointStackCount.value(key, 0);
         if (stackCount == 1)
-            gridPointWidth.insert(key, CARD_WIDTH * (1 + cards[i]->getAttachedCards().size() / 3.0));
+            gridPointWidth.insert(key, CARD_WIDTH * (1 + rowCards[i]->getAttachedCards().size() / 3.0));
         else
             gridPointWidth.insert(key, CARD_WIDTH * (1 + (stackCount - 1) / 3.0));
     }
     
-    for (int i = 0; i < cards.size(); ++i) {
-        QPoint gridPoint = cards[i]->getGridPos();
+    for (int i = 0; i < rowCards.size(); ++i) {
+        QPoint gridPoint = rowCards[i]->getGridPos();
         if (gridPoint.x() == -1)
             continue;
         
@@ -198,31 +245,29 @@ void TableZone::reorganizeCards()
         qreal x = mapPoint.x();
         qreal y = mapPoint.y();
         
-        int numberAttachedCards = cards[i]->getAttachedCards().size();
+        int numberAttachedCards = rowCards[i]->getAttachedCards().size();
         qreal actualX = x + numberAttachedCards * CARD_WIDTH / 3.0;
         qreal actualY = y;
         if (numberAttachedCards)
             actualY += 15;
         
-        cards[i]->setPos(actualX, actualY);
-        cards[i]->setRealZValue((actualY + CARD_HEIGHT) * 100000 + (actualX + 1) * 100);
+        if (placeCard(rowCards[i], actualX, actualY) || allRows) {
+            arrowsToUpdate.append(rowCards[i]->getArrowsFrom());
+            arrowsToUpdate.append(rowCards[i]->getArrowsTo());
+        }
         
-        QListIterator<CardItem *> attachedCardIterator(cards[i]->getAttachedCards());
+        QListIterator<CardItem *> attachedCardIterator(rowCards[i]->getAttachedCards());
         int j = 0;
         while (attachedCardIterator.hasNext()) {
             ++j;
             CardItem *attachedCard = attachedCardIterator.next();
             qreal childX = actualX - j * CARD_WIDTH / 3.0;
             qreal childY = y + 5;
-            attachedCard->setPos(childX, childY);
-            attachedCard->setRealZValue((childY + CARD_HEIGHT) * 100000 + (childX + 1) * 100);
-
-            arrowsToUpdate.append(attachedCard->getArrowsFrom());
-            arrowsToUpdate.append(attachedCard->getArrowsTo());
+            if (placeCard(attachedCard, childX, childY) || allRows) {
+                arrowsToUpdate.append(attachedCard->getArrowsFrom());
+                arrowsToUpdate.append(attachedCard->getArrowsTo());
+            }
         }
-        
-        arrowsToUpdate.append(cards[i]->getArrowsFrom());
-        arrowsToUpdate.append(cards[i]->getArrowsTo());
     }
 
     QSetIterator<ArrowItem *> arrowIterator(QSet<ArrowItem *>::fromList(arrowsToUpdate));
@@ -230,7 +275,20 @@ void TableZone::reorganizeCards()
         arrowIterator.next()->updatePath();
     
     resizeToContents();
-    update();
+    if (allRows)
+        update();
+}
+
+
+bool TableZone::placeCard(CardItem *card, qreal x, qreal y)
+{
+    const qreal realZValue = (y + CARD_HEIGHT) * 100000 + (x + 1) * 100;
+    if ((card->pos() == QPointF(x, y)) && (card->getRealZValue() == realZValue))
+        return false;
+
+    card->setPos(x, y);
+    card->setRealZValue(realZValue);
+    return true;
 }
 
 
@@ -11,7 +11,7 @@
 * It is the main play zone and can be customized with background images.
 *
 * TODO: Refactor methods to make more readable, extract some logic to
-* private methods (Im looking at you TableZone::reorganizeCards())
+* private methods (Im looking at you TableZone::reorganizeCardsImpl())
 */
 class TableZone : public SelectZone {
     Q_OBJECT
@@ -53,7 +53,21 @@ private:
      */
     bool active;
 
+    /*
+       The rows whose layout is out of date, one bit per row, and whether
+       all cards have to be laid out because of a change not tied to a row
+     */
+    int dirtyRows;
+    bool allRowsDirty;
+
     bool isInverted() const;
+    void invalidateRow(int row);
+
+    /*
+       Moves a card to a position given by the layout.
+       @return whether it was not there already
+     */
+    bool placeCard(CardItem *card, qreal x, qreal y);
 
 private slots:
     /**
@@ -61,12 +75,6 @@ private slots:
      */
     void updateBgPixmap();
 
-public slots:
-    /**
-       Reorganizes CardItems in the TableZone
-     */
-    void reorganizeCards();
-
 public:
     /**
        Constructs TableZone.
@@ -144,6 +152,14 @@ public:
 protected:
     void addCardImpl(CardItem *card, int x, int y);
 
+    /**
+       Reorganizes the CardItems in the rows of the TableZone which have
+       changed. Only cards which actually move are repositioned, and only
+       their arrows are updated.
+     */
+    void reorganizeCardsImpl();
+    void invalidateLayout(CardItem *changedCard);
+
 private:
     void paintZoneOutline(QPainter *painter);
     void paintLandDivider(QPainter *painter);
@@ -0,0 +1,166 @@
+#include "thumbnailcache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSet>
+
+const quint32 ThumbnailCache::fileMagic = 0x43545448; // "CTTH"
+const qint64 ThumbnailCache::maxTotalSize = 256 * 1024 * 1024;
+const int ThumbnailCache::maxThumbnailWidth = 256;
+
+ThumbnailCache::ThumbnailCache(const QString &_dir)
+    : dir(_dir), totalSize(0)
+{
+    QDir().mkpath(dir);
+
+    QFileInfoList files = QDir(dir).entryInfoList(QStringList() << "*.thumb", QDir::Files, QDir::Time | QDir::Reversed);
+    for (int i = 0; i < files.size(); ++i) {
+        fileSizes.insert(files[i].fileName(), files[i].size());
+        totalSize += files[i].size();
+    }
+
+    // The order of use is kept in the index. Files missing from it
+    // are older than all of those in it, and ordered by modification time.
+    QStringList indexedFiles;
+    QFile indexFile(indexFileName());
+    if (indexFile.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&indexFile);
+        stream >> indexedFiles;
+    }
+    QSet<QString> indexedFileSet;
+    for (int i = 0; i < indexedFiles.size(); ++i)
+        if (fileSizes.contains(indexedFiles[i]))
+            indexedFileSet.insert(indexedFiles[i]);
+    for (int i = 0; i < files.size(); ++i)
+        if (!indexedFileSet.contains(files[i].fileName()))
+            usage.append(files[i].fileName());
+    for (int i = 0; i < indexedFiles.size(); ++i)
+        if (indexedFileSet.remove(indexedFiles[i]))
+            usage.append(indexedFiles[i]);
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    QFile indexFile(indexFileName());
+    if (indexFile.open(QIODevice::WriteOnly)) {
+        QDataStream stream(&indexFile);
+        stream << usage;
+    }
+}
+
+QString ThumbnailCache::fileNameOf(const QFileInfo &source)
+{
+    QByteArray key = source.absoluteFilePath().toUtf8();
+    key += '\n' + QByteArray::number(source.size());
+    key += '\n' + QByteArray::number(source.lastModified().toMSecsSinceEpoch());
+    return QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex() + ".thumb";
+}
+
+void ThumbnailCache::touch(const QString &fileName)
+{
+    usage.removeOne(fileName);
+    usage.append(fileName);
+}
+
+void ThumbnailCache::removeFile(const QString &fileName)
+{
+    QFile::remove(dir + "/" + fileName);
+    usage.removeOne(fileName);
+    totalSize -= fileSizes.take(fileName);
+}
+
+bool ThumbnailCache::contains(const QString &sourceFile)
+{
+    const QString fileName = fileNameOf(QFileInfo(sourceFile));
+
+    QMutexLocker locker(&mutex);
+    return fileSizes.contains(fileName);
+}
+
+bool ThumbnailCache::load(const QString &sourceFile, QList<QImage> &thumbnails)
+{
+    const QString fileName = fileNameOf(QFileInfo(sourceFile));
+    {
+        QMutexLocker locker(&mutex);
+        if (!fileSizes.contains(fileName))
+            return false;
+        touch(fileName);
+    }
+
+    QFile file(dir + "/" + fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+
+    quint32 magic;
+    qint32 count;
+    stream >> magic >> count;
+    if (magic != fileMagic)
+        return false;
+
+    thumbnails.clear();
+    for (int i = 0; i < count; ++i) {
+        qint32 width, height, format;
+        stream >> width >> height >> format;
+        if ((stream.status() != QDataStream::Ok) || (width <= 0) || (width > maxThumbnailWidth) || (height <= 0) || (height > 4 * maxThumbnailWidth))
+            return false;
+        if ((format != QImage::Format_RGB32) && (format != QImage::Format_ARGB32_Premultiplied))
+            return false;
+
+        QImage thumbnail(width, height, (QImage::Format) format);
+        if (stream.readRawData((char *) thumbnail.bits(), thumbnail.byteCount()) != thumbnail.byteCount())
+            return false;
+        thumbnails.append(thumbnail);
+    }
+
+    return !thumbnails.isEmpty();
+}
+
+void ThumbnailCache::store(const QString &sourceFile, const QList<QImage> &levels)
+{
+    // the picture itself is never stored, only the levels scaled from it
+    QList<QImage> thumbnails;
+    for (int i = 1; i < levels.size(); ++i)
+        if (levels[i].width() <= maxThumbnailWidth) {
+            if ((levels[i].format() == QImage::Format_RGB32) || (levels[i].format() == QImage::Format_ARGB32_Premultiplied))
+                thumbnails.append(levels[i]);
+            else
+                thumbnails.append(levels[i].convertToFormat(QImage::Format_ARGB32_Premultiplied));
+        }
+    if (thumbnails.isEmpty())
+        return;
+
+    const QString fileName = fileNameOf(QFileInfo(sourceFile));
+    QFile file(dir + "/" + fileName + ".tmp");
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream << fileMagic << (qint32) thumbnails.size();
+    for (int i = 0; i < thumbnails.size(); ++i) {
+        const QImage &thumbnail = thumbnails[i];
+        stream << (qint32) thumbnail.width() << (qint32) thumbnail.height() << (qint32) thumbnail.format();
+        stream.writeRawData((const char *) thumbnail.constBits(), thumbnail.byteCount());
+    }
+    const qint64 size = file.size();
+    file.close();
+
+    QMutexLocker locker(&mutex);
+    if (fileSizes.contains(fileName))
+        removeFile(fileName);
+    if (!QFile::rename(file.fileName(), dir + "/" + fileName)) {
+        QFile::remove(file.fileName());
+        return;
+    }
+    fileSizes.insert(fileName, size);
+    usage.append(fileName);
+    totalSize += size;
+
+    while ((totalSize > maxTotalSize) && (usage.size() > 1))
+        removeFile(usage.first());
+}
@@ -0,0 +1,48 @@
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+
+class QFileInfo;
+
+/*
+ * Small versions of the card pictures, stored on disk as raw image data so
+ * that they load without decoding a JPEG or PNG. They are keyed by the path,
+ * size and modification time of the picture file they were made from, and
+ * the least recently used ones are deleted when the cache grows too large.
+ *
+ * All methods may be called from any thread.
+ */
+class ThumbnailCache {
+private:
+    static const quint32 fileMagic;
+    static const qint64 maxTotalSize;
+    static const int maxThumbnailWidth;
+
+    QMutex mutex;
+    QString dir;
+    // the file names, least recently used first
+    QStringList usage;
+    QHash<QString, qint64> fileSizes;
+    qint64 totalSize;
+
+    static QString fileNameOf(const QFileInfo &source);
+    QString indexFileName() const { return dir + "/index"; }
+    void touch(const QString &fileName);
+    void removeFile(const QString &fileName);
+public:
+    ThumbnailCache(const QString &_dir);
+    ~ThumbnailCache();
+
+    bool contains(const QString &sourceFile);
+    // Reads the thumbnails of a picture file, largest first.
+    bool load(const QString &sourceFile, QList<QImage> &thumbnails);
+    // Stores the levels of a picture file which are small enough to be thumbnails.
+    void store(const QString &sourceFile, const QList<QImage> &levels);
+};
+
+#endif
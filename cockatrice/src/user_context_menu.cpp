@@ -115,11 +115,12 @@ void UserContextMenu::showContextMenu(const QPoint &pos, const QString &userName
     menu->addAction(aChat);
     if (userLevel.testFlag(ServerInfo_User::IsRegistered) && (tabSupervisor->getUserInfo()->user_level() & ServerInfo_User::IsRegistered)) {
         menu->addSeparator();
-        if (tabSupervisor->getUserListsTab()->getBuddyList()->getUsers().contains(userName))
+        const UserDirectory &userDirectory = tabSupervisor->getUserListsTab()->getUserDirectory();
+        if (userDirectory.isBuddy(userName))
             menu->addAction(aRemoveFromBuddyList);
         else
             menu->addAction(aAddToBuddyList);
-        if (tabSupervisor->getUserListsTab()->getIgnoreList()->getUsers().contains(userName))
+        if (userDirectory.isIgnored(userName))
             menu->addAction(aRemoveFromIgnoreList);
         else
             menu->addAction(aAddToIgnoreList);
@@ -0,0 +1,30 @@
+#include "userdirectory.h"
+
+void UserDirectory::setUserOnline(const ServerInfo_User &user)
+{
+    const QString userName = QString::fromStdString(user.name());
+    userLevels.insert(userName, UserLevelFlags(user.user_level()));
+    userNamesByLowerCase.insert(userName.toLower(), userName);
+}
+
+void UserDirectory::setUserOffline(const QString &userName)
+{
+    userLevels.remove(userName);
+    userNamesByLowerCase.remove(userName.toLower());
+}
+
+void UserDirectory::setBuddy(const QString &userName, bool buddy)
+{
+    if (buddy)
+        buddies.insert(userName);
+    else
+        buddies.remove(userName);
+}
+
+void UserDirectory::setIgnored(const QString &userName, bool ignored)
+{
+    if (ignored)
+        ignoredUsers.insert(userName);
+    else
+        ignoredUsers.remove(userName);
+}
@@ -0,0 +1,34 @@
+#ifndef USERDIRECTORY_H
+#define USERDIRECTORY_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include "user_level.h"
+
+/*
+ * What the chat and message handlers need to know about other users,
+ * kept apart from the user list widgets so that it can be looked up
+ * for every message: the level of the users online, their names by
+ * their lower case version, and who is a buddy or ignored.
+ */
+class UserDirectory {
+private:
+    QHash<QString, UserLevelFlags> userLevels;
+    QHash<QString, QString> userNamesByLowerCase;
+    QSet<QString> buddies, ignoredUsers;
+public:
+    void setUserOnline(const ServerInfo_User &user);
+    void setUserOffline(const QString &userName);
+    void setBuddy(const QString &userName, bool buddy);
+    void setIgnored(const QString &userName, bool ignored);
+
+    bool isOnline(const QString &userName) const { return userLevels.contains(userName); }
+    UserLevelFlags getUserLevel(const QString &userName) const { return userLevels.value(userName); }
+    bool isBuddy(const QString &userName) const { return buddies.contains(userName); }
+    bool isIgnored(const QString &userName) const { return ignoredUsers.contains(userName); }
+    // Returns the correctly cased name of a user online, or an empty string.
+    QString getUserNameCaseInsensitive(const QString &userName) const { return userNamesByLowerCase.value(userName.toLower()); }
+};
+
+#endif
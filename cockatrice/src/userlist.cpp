@@ -207,7 +207,7 @@ bool UserListTWI::operator<(const QTreeWidgetItem &other) const
 }
 
 UserList::UserList(TabSupervisor *_tabSupervisor, AbstractClient *_client, UserListType _type, QWidget *parent)
-    : QGroupBox(parent), tabSupervisor(_tabSupervisor), client(_client), type(_type), onlineCount(0)
+    : QGroupBox(parent), tabSupervisor(_tabSupervisor), client(_client), type(_type), onlineCount(0), bulkUpdate(false)
 {
     itemDelegate = new UserListItemDelegate(this);
     userContextMenu = new UserContextMenu(tabSupervisor, this);
@@ -251,17 +251,22 @@ void UserList::processUserInfo(const ServerInfo_User &user, bool online)
 {
     const QString userName = QString::fromStdString(user.name());
     UserListTWI *item = users.value(userName);
-    if (item)
+    if (item) {
         item->setUserInfo(user);
-    else {
+        item->setOnline(online);
+        sortItem(item);
+    } else {
         item = new UserListTWI(user);
+        item->setOnline(online);
         users.insert(userName, item);
-        userTree->addTopLevelItem(item);
+        if (bulkUpdate)
+            userTree->addTopLevelItem(item);
+        else
+            userTree->insertTopLevelItem(findSortedIndex(item), item);
         if (online)
             ++onlineCount;
         updateCount();
     }
-    item->setOnline(online);
 }
 
 bool UserList::deleteUser(const QString &userName)
@@ -287,6 +292,7 @@ void UserList::setUserOnline(const QString &userName, bool online)
         return;
     
     twi->setOnline(online);
+    sortItem(twi);
     if (online)
         ++onlineCount;
     else
@@ -294,6 +300,37 @@ void UserList::setUserOnline(const QString &userName, bool online)
     updateCount();
 }
 
+int UserList::findSortedIndex(const UserListTWI *item) const
+{
+    // the index of the first item which does not sort before the given one
+    int low = 0;
+    int high = userTree->topLevelItemCount();
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        if (*userTree->topLevelItem(middle) < *item)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+void UserList::sortItem(UserListTWI *item)
+{
+    if (bulkUpdate)
+        return;
+
+    const int index = userTree->indexOfTopLevelItem(item);
+    const int count = userTree->topLevelItemCount();
+    const bool afterPrevious = (index == 0) || !(*item < *userTree->topLevelItem(index - 1));
+    const bool beforeNext = (index == count - 1) || !(*userTree->topLevelItem(index + 1) < *item);
+    if (afterPrevious && beforeNext)
+        return;
+
+    userTree->takeTopLevelItem(index);
+    userTree->insertTopLevelItem(findSortedIndex(item), item);
+}
+
 void UserList::updateCount()
 {
     QString str = titleStr;
@@ -315,7 +352,13 @@ void UserList::showContextMenu(const QPoint &pos, const QModelIndex &index)
     userContextMenu->showContextMenu(pos, QString::fromStdString(userInfo.name()), UserLevelFlags(userInfo.user_level()), online);
 }
 
-void UserList::sortItems()
+void UserList::beginBulkUpdate()
+{
+    bulkUpdate = true;
+}
+
+void UserList::endBulkUpdate()
 {
+    bulkUpdate = false;
     userTree->sortItems(1, Qt::AscendingOrder);
 }
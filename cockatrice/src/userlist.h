@@ -72,7 +72,11 @@ private:
     UserContextMenu *userContextMenu;
     int onlineCount;
     QString titleStr;
+    // While set, new users are appended and the list is only sorted in endBulkUpdate().
+    bool bulkUpdate;
     void updateCount();
+    int findSortedIndex(const UserListTWI *item) const;
+    void sortItem(UserListTWI *item);
 private slots:
     void userClicked(QTreeWidgetItem *item, int column);
 signals:
@@ -89,7 +93,10 @@ public:
     void setUserOnline(const QString &userName, bool online);
     const QMap<QString, UserListTWI *> &getUsers() const { return users; }
     void showContextMenu(const QPoint &pos, const QModelIndex &index);
-    void sortItems();
+    // The list is kept sorted as users are added and changed. Many changes at once
+    // should be made between these, so that the list is sorted only once.
+    void beginBulkUpdate();
+    void endBulkUpdate();
 };
 
 #endif
@@ -30,6 +30,8 @@
 #include <QDateTime>
 #include <QSystemTrayIcon>
 #include <QApplication>
+#include <QDir>
+#include <QTimer>
 #if QT_VERSION < 0x050000
     // for Qt::escape() 
     #include <QtGui/qtextdocument.h>
@@ -46,6 +48,7 @@
 #include "localserverinterface.h"
 #include "localclient.h"
 #include "settingscache.h"
+#include "carddatabase.h"
 #include "tab_game.h"
 
 #include "version_string.h"
@@ -541,10 +544,15 @@ void MainWindow::createMenus()
 }
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), localServer(0), bHasActivated(false), cardUpdateProcess(0)
+    : QMainWindow(parent), localServer(0), bHasActivated(false), cardUpdateProcess(0), triedFallbackCardDatabase(false)
 {
-    connect(settingsCache, SIGNAL(pixmapCacheSizeChanged(int)), this, SLOT(pixmapCacheSizeChanged(int)));
-    pixmapCacheSizeChanged(settingsCache->getPixmapCacheSize());
+    // The pixmap cache size setting is the budget of the card pictures, which have their own
+    // cache. QPixmapCache only holds the hand counters and player avatars, a few megabytes are plenty.
+    QPixmapCache::setCacheLimit(8 * 1024);
+
+    connect(db, SIGNAL(databaseLoaded()), this, SLOT(cardDatabaseLoadFinished()));
+    if (!db->isLoading())
+        QTimer::singleShot(0, this, SLOT(cardDatabaseLoadFinished()));
 
     client = new RemoteClient;
     connect(client, SIGNAL(connectionClosedEventReceived(const Event_ConnectionClosed &)), this, SLOT(processConnectionClosedEvent(const Event_ConnectionClosed &)));
@@ -666,11 +674,35 @@ void MainWindow::changeEvent(QEvent *event)
     QMainWindow::changeEvent(event);
 }
 
-void MainWindow::pixmapCacheSizeChanged(int newSizeInMBs)
+void MainWindow::cardDatabaseLoadFinished()
 {
-    //qDebug() << "Setting pixmap cache size to " << value << " MBs";
-    // translate MBs to KBs
-    QPixmapCache::setCacheLimit(newSizeInMBs * 1024);
+    // Checks the result of the card database loads started at program startup.
+    if (db->isLoading())
+        return;
+
+    if (!db->getLoadSuccess() && !triedFallbackCardDatabase) {
+        triedFallbackCardDatabase = true;
+        const QString fallbackPath = dataDir + "/cards.xml";
+        if (QFile::exists(fallbackPath) && (settingsCache->getCardDatabasePath() != fallbackPath)) {
+            // reloads the database in the background, we get called again when it is done
+            settingsCache->setCardDatabasePath(fallbackPath);
+            return;
+        }
+    }
+    disconnect(db, SIGNAL(databaseLoaded()), this, SLOT(cardDatabaseLoadFinished()));
+
+    if (QDir().mkpath(dataDir + "/customsets"))
+    {
+        // if the dir exists (or has just been created)
+        db->loadCustomCardDatabases(dataDir + "/customsets");
+    } else {
+        qDebug() << "Could not create " + dataDir + "/customsets folder.";
+    }
+
+    if (db->getLoadStatus() != Ok) {
+        qDebug("MainWindow: invalid card database load status");
+        actSettings();
+    }
 }
 
 void MainWindow::maximize() {
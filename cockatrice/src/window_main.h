@@ -52,7 +52,7 @@ private slots:
     void registerAcceptedNeedsActivate();
     void activateAccepted();
     void localGameEnded();
-    void pixmapCacheSizeChanged(int newSizeInMBs);
+    void cardDatabaseLoadFinished();
 
     void actConnect();
     void actDisconnect();
@@ -103,6 +103,7 @@ private:
 
     QMessageBox serverShutdownMessageBox;
     QProcess * cardUpdateProcess;
+    bool triedFallbackCardDatabase;
 public:
     MainWindow(QWidget *parent = 0);
     ~MainWindow();
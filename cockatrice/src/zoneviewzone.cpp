@@ -3,6 +3,8 @@
 #include <QGraphicsSceneWheelEvent>
 #include <QBrush>
 #include <QPainter>
+#include <QSet>
+#include "arrowitem.h"
 #include "zoneviewzone.h"
 #include "player.h"
 #include "carddragitem.h"
@@ -81,7 +83,7 @@ void ZoneViewZone::zoneDumpReceived(const Response &r)
 }
 
 // Because of boundingRect(), this function must not be called before the zone was added to a scene.
-void ZoneViewZone::reorganizeCards()
+void ZoneViewZone::reorganizeCardsImpl()
 {
     int cardCount = cards.size();
     if (!origZone->contentsKnown())
@@ -109,6 +111,7 @@ void ZoneViewZone::reorganizeCards()
     if (sortByName || sortByType)
         cardsToDisplay.sort((sortByName ? CardList::SortByName : 0) | (sortByType ? CardList::SortByType : 0));
 
+    QList<ArrowItem *> arrowsToUpdate;
     int typeColumn = 0;
     int longestRow = 0;
     if (pileView && sortByType) { // we need sort by type enabled for the feature to work
@@ -130,7 +133,11 @@ void ZoneViewZone::reorganizeCards()
             lastCardType = cardType;
             qreal x = 7 + (typeColumn * CARD_WIDTH);
             qreal y = typeRow * CARD_HEIGHT / 3;
-            c->setPos(x + 5, y + 5);
+            if (c->pos() != QPointF(x + 5, y + 5)) {
+                c->setPos(x + 5, y + 5);
+                arrowsToUpdate.append(c->getArrowsFrom());
+                arrowsToUpdate.append(c->getArrowsTo());
+            }
             c->setRealZValue(i);
             longestRow = qMax(typeRow, longestRow);
         }
@@ -139,10 +146,18 @@ void ZoneViewZone::reorganizeCards()
             CardItem *c = cardsToDisplay.at(i);
             qreal x = 7 + ((i / rows) * CARD_WIDTH);
             qreal y = (i % rows) * CARD_HEIGHT / 3;
-            c->setPos(x + 5, y + 5);
+            if (c->pos() != QPointF(x + 5, y + 5)) {
+                c->setPos(x + 5, y + 5);
+                arrowsToUpdate.append(c->getArrowsFrom());
+                arrowsToUpdate.append(c->getArrowsTo());
+            }
             c->setRealZValue(i);
         }
     }
+
+    QSetIterator<ArrowItem *> arrowIterator(QSet<ArrowItem *>::fromList(arrowsToUpdate));
+    while (arrowIterator.hasNext())
+        arrowIterator.next()->updatePath();
     
     qreal aleft = 0;
     qreal atop = 0;
@@ -25,7 +25,6 @@ public:
     ~ZoneViewZone();
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-    void reorganizeCards();
     void initializeCards(const QList<const ServerInfo_Card *> &cardList = QList<const ServerInfo_Card *>());
     void removeCard(int position);
     int getNumberCards() const { return numberCards; }
@@ -46,6 +45,7 @@ signals:
     void wheelEventReceived(QGraphicsSceneWheelEvent *event);
 protected:
     void addCardImpl(CardItem *card, int x, int y);
+    void reorganizeCardsImpl();
     QSizeF sizeHint(Qt::SizeHint which, const QSizeF &constraint = QSizeF()) const;
     void wheelEvent(QGraphicsSceneWheelEvent *event);
 };
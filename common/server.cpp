@@ -193,6 +193,20 @@ QList<PlayerReference> Server::getPersistentPlayerReferences(const QString &user
     return persistentPlayers.values(userName);
 }
 
+void Server::reportFlood(const QString &userName)
+{
+    QMutexLocker locker(&floodReportMutex);
+    ++floodReport[userName];
+}
+
+QMap<QString, int> Server::takeFloodReport()
+{
+    QMutexLocker locker(&floodReportMutex);
+    QMap<QString, int> result = floodReport;
+    floodReport.clear();
+    return result;
+}
+
 Server_AbstractUserInterface *Server::findUser(const QString &userName) const
 {
     // Call this only with clientsLock set.
@@ -240,7 +254,7 @@ void Server::removeClient(Server_ProtocolHandler *client)
 
 void Server::externalUserJoined(const ServerInfo_User &userInfo)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     clientsLock.lockForWrite();
     
     Server_RemoteUserInterface *newUser = new Server_RemoteUserInterface(this, ServerInfo_User_Container(userInfo));
@@ -264,7 +278,7 @@ void Server::externalUserJoined(const ServerInfo_User &userInfo)
 
 void Server::externalUserLeft(const QString &userName)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     
     clientsLock.lockForWrite();
     Server_AbstractUserInterface *user = externalUsers.take(userName);
@@ -310,7 +324,7 @@ void Server::externalUserLeft(const QString &userName)
 
 void Server::externalRoomUserJoined(int roomId, const ServerInfo_User &userInfo)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     QReadLocker locker(&roomsLock);
     
     Server_Room *room = rooms.value(roomId);
@@ -323,7 +337,7 @@ void Server::externalRoomUserJoined(int roomId, const ServerInfo_User &userInfo)
 
 void Server::externalRoomUserLeft(int roomId, const QString &userName)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     QReadLocker locker(&roomsLock);
     
     Server_Room *room = rooms.value(roomId);
@@ -336,7 +350,7 @@ void Server::externalRoomUserLeft(int roomId, const QString &userName)
 
 void Server::externalRoomSay(int roomId, const QString &userName, const QString &message)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     QReadLocker locker(&roomsLock);
     
     Server_Room *room = rooms.value(roomId);
@@ -351,7 +365,7 @@ void Server::externalRoomSay(int roomId, const QString &userName, const QString
 
 void Server::externalRoomGameListChanged(int roomId, const ServerInfo_Game &gameInfo)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     QReadLocker locker(&roomsLock);
     
     Server_Room *room = rooms.value(roomId);
@@ -364,7 +378,7 @@ void Server::externalRoomGameListChanged(int roomId, const ServerInfo_Game &game
 
 void Server::externalJoinGameCommandReceived(const Command_JoinGame &cmd, int cmdId, int roomId, int serverId, qint64 sessionId)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     
     try {
         QReadLocker roomsLocker(&roomsLock);
@@ -395,7 +409,7 @@ void Server::externalJoinGameCommandReceived(const Command_JoinGame &cmd, int cm
 
 void Server::externalGameCommandContainerReceived(const CommandContainer &cont, int playerId, int serverId, qint64 sessionId)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     
     try {
         ResponseContainer responseContainer(cont.cmd_id());
@@ -450,7 +464,7 @@ void Server::externalGameCommandContainerReceived(const CommandContainer &cont,
 
 void Server::externalGameEventContainerReceived(const GameEventContainer &cont, qint64 sessionId)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     
     QReadLocker usersLocker(&clientsLock);
     
@@ -464,7 +478,7 @@ void Server::externalGameEventContainerReceived(const GameEventContainer &cont,
 
 void Server::externalResponseReceived(const Response &resp, qint64 sessionId)
 {
-    // This function is always called from the main thread via signal/slot.
+    // This function is always called from an ISL replication thread.
     
     QReadLocker usersLocker(&clientsLock);
     
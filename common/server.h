@@ -52,7 +52,7 @@ public:
     const QMap<QString, Server_ProtocolHandler *> &getUsers() const { return users; }
     const QMap<qint64, Server_ProtocolHandler *> &getUsersBySessionId() const { return usersBySessionId; }
     void addClient(Server_ProtocolHandler *player);
-    void removeClient(Server_ProtocolHandler *player);
+    virtual void removeClient(Server_ProtocolHandler *player);
     virtual QString getLoginMessage() const { return QString(); }
     
     virtual bool getGameShouldPing() const { return false; }
@@ -84,13 +84,18 @@ public:
     void addPersistentPlayer(const QString &userName, int roomId, int gameId, int playerId);
     void removePersistentPlayer(const QString &userName, int roomId, int gameId, int playerId);
     QList<PlayerReference> getPersistentPlayerReferences(const QString &userName) const;
+    
+    void reportFlood(const QString &userName);
+    QMap<QString, int> takeFloodReport();
 private:
     bool threaded;
     QMultiMap<QString, PlayerReference> persistentPlayers;
     mutable QReadWriteLock persistentPlayersLock;
+    QMap<QString, int> floodReport;
+    QMutex floodReportMutex;
     int nextLocalGameId;
     QMutex nextLocalGameIdMutex;
-protected slots:    
+public slots:
     void externalUserJoined(const ServerInfo_User &userInfo);
     void externalUserLeft(const QString &userName);
     void externalRoomUserJoined(int roomId, const ServerInfo_User &userInfo);
@@ -101,7 +106,7 @@ protected slots:
     void externalGameCommandContainerReceived(const CommandContainer &cont, int playerId, int serverId, qint64 sessionId);
     void externalGameEventContainerReceived(const GameEventContainer &cont, qint64 sessionId);
     void externalResponseReceived(const Response &resp, qint64 sessionId);
-    
+protected slots:
     virtual void doSendIslMessage(const IslMessage & /* msg */, int /* serverId */) { }
 protected:
     void prepareDestroy();
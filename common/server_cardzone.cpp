@@ -291,3 +291,18 @@ void Server_CardZone::getInfo(ServerInfo_Zone *info, Server_Player *playerWhosAs
             cardIterator.next()->getInfo(info->add_card_list());
     }
 }
+
+void Server_CardZone::addPrivateInfo(ServerInfo_Zone *info)
+{
+    if (type != ServerInfo_Zone::PrivateZone)
+        return;
+    QListIterator<Server_Card *> cardIterator(cards);
+    while (cardIterator.hasNext())
+        cardIterator.next()->getInfo(info->add_card_list());
+}
+
+void Server_CardZone::removePrivateInfo(ServerInfo_Zone *info)
+{
+    if (type == ServerInfo_Zone::PrivateZone)
+        info->clear_card_list();
+}
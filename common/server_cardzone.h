@@ -61,6 +61,9 @@ public:
     QString getName() const { return name; }
     Server_Player *getPlayer() const { return player; }
     void getInfo(ServerInfo_Zone *info, Server_Player *playerWhosAsking, bool omniscient);
+    // Cards only the owner (or an omniscient spectator) sees, on top of getInfo(info, 0, false).
+    void addPrivateInfo(ServerInfo_Zone *info);
+    void removePrivateInfo(ServerInfo_Zone *info);
     
     int getFreeGridColumn(int x, int y, const QString &cardName, bool dontStackSameName) const;
     bool isColumnEmpty(int x, int y) const;
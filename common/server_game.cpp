@@ -252,40 +252,52 @@ void Server_Game::createGameStateChangedEvent(Event_GameStateChanged *event, Ser
 
 void Server_Game::sendGameStateToPlayers()
 {
+    // The public view of the game is built once. The views of the players and of omniscient
+    // spectators differ from it only in the contents of private zones and the deck list,
+    // which are added to the shared event before it is serialized for them and removed afterwards.
+    Event_GameStateChanged event;
+    createGameStateChangedEvent(&event, 0, false, false);
+    
+    QList<Server_Player *> playerList = players.values(); // same order as event.player_list()
+    
     // game state information for replay and omniscient spectators
-    Event_GameStateChanged omniscientEvent;
-    createGameStateChangedEvent(&omniscientEvent, 0, true, false);
-
-    GameEventContainer *replayCont = prepareGameEvent(omniscientEvent, -1);
+    for (int i = 0; i < playerList.size(); ++i)
+        playerList[i]->addPrivateInfo(event.mutable_player_list(i), false);
+    
+    GameEventContainer *replayCont = prepareGameEvent(event, -1);
     replayCont->set_seconds_elapsed(secondsElapsed - startTimeOfThisGame);
     replayCont->clear_game_id();
     currentReplay->add_event_list()->CopyFrom(*replayCont);
     delete replayCont;
-
-    // If spectators are not omniscient, we need an additional createGameStateChangedEvent call, otherwise we can use the data we used for the replay.
-    // All spectators are equal, so we don't need to make a createGameStateChangedEvent call for each one.
-    Event_GameStateChanged spectatorEvent;
+    
+    // All spectators are equal, so they share one container.
+    GameEventContainer *spectatorCont = 0;
     if (spectatorsSeeEverything)
-        spectatorEvent = omniscientEvent;
-    else
-        createGameStateChangedEvent(&spectatorEvent, 0, false, false);
-
+        spectatorCont = prepareGameEvent(event, -1);
+    
+    for (int i = 0; i < playerList.size(); ++i)
+        playerList[i]->removePrivateInfo(event.mutable_player_list(i));
+    
+    if (!spectatorsSeeEverything)
+        spectatorCont = prepareGameEvent(event, -1);
+    
     // send game state info to clients according to their role in the game
-    QMapIterator<int, Server_Player *> playerIterator(players);
-    while (playerIterator.hasNext()) {
-        Server_Player *player = playerIterator.next().value();
-        GameEventContainer *gec;
-        if (player->getSpectator())
-            gec = prepareGameEvent(spectatorEvent, -1);
-        else {
-            Event_GameStateChanged event;
-            createGameStateChangedEvent(&event, player, false, false);
-
-            gec = prepareGameEvent(event, -1);
+    for (int i = 0; i < playerList.size(); ++i) {
+        Server_Player *player = playerList[i];
+        if (player->getSpectator()) {
+            player->sendGameEvent(*spectatorCont);
+            continue;
         }
+        
+        ServerInfo_Player *ownInfo = event.mutable_player_list(i);
+        player->addPrivateInfo(ownInfo, true);
+        GameEventContainer *gec = prepareGameEvent(event, -1);
+        player->removePrivateInfo(ownInfo);
+        
         player->sendGameEvent(*gec);
         delete gec;
     }
+    delete spectatorCont;
 }
 
 void Server_Game::doStartGameIfReady()
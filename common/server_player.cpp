@@ -651,6 +651,7 @@ Response::ResponseCode Server_Player::cmdDeckSelect(const Command_DeckSelect &cm
     
     delete deck;
     deck = newDeck;
+    deckListCache.clear();
     sideboardLocked = true;
     
     Event_PlayerPropertiesChanged event;
@@ -664,7 +665,7 @@ Response::ResponseCode Server_Player::cmdDeckSelect(const Command_DeckSelect &cm
     ges.setGameEventContext(context);
     
     Response_DeckDownload *re = new Response_DeckDownload;
-    re->set_deck(deck->writeToString_Native().toStdString());
+    re->set_deck(getDeckListString());
     
     rc.setResponseExtension(re);
     return Response::RespOk;
@@ -685,6 +686,7 @@ Response::ResponseCode Server_Player::cmdSetSideboardPlan(const Command_SetSideb
     for (int i = 0; i < cmd.move_list_size(); ++i)
         sideboardPlan.append(cmd.move_list(i));
     deck->setCurrentSideboardPlan(sideboardPlan);
+    deckListCache.clear();
     
     return Response::RespOk;
 }
@@ -701,8 +703,10 @@ Response::ResponseCode Server_Player::cmdSetSideboardLock(const Command_SetSideb
         return Response::RespContextError;
     
     sideboardLocked = cmd.locked();
-    if (sideboardLocked)
+    if (sideboardLocked) {
         deck->setCurrentSideboardPlan(QList<MoveCard_ToZone>());
+        deckListCache.clear();
+    }
     
     Event_PlayerPropertiesChanged event;
     event.mutable_player_properties()->set_sideboard_locked(sideboardLocked);
@@ -1723,9 +1727,6 @@ void Server_Player::disconnectClient()
 void Server_Player::getInfo(ServerInfo_Player *info, Server_Player *playerWhosAsking, bool omniscient, bool withUserInfo)
 {
     getProperties(*info->mutable_properties(), withUserInfo);
-    if (playerWhosAsking == this)
-        if (deck)
-            info->set_deck_list(deck->writeToString_Native().toStdString());
     
     QMapIterator<int, Server_Arrow *> arrowIterator(arrows);
     while (arrowIterator.hasNext())
@@ -1737,5 +1738,37 @@ void Server_Player::getInfo(ServerInfo_Player *info, Server_Player *playerWhosAs
     
     QMapIterator<QString, Server_CardZone *> zoneIterator(zones);
     while (zoneIterator.hasNext())
-        zoneIterator.next().value()->getInfo(info->add_zone_list(), playerWhosAsking, omniscient);    
+        zoneIterator.next().value()->getInfo(info->add_zone_list(), 0, false);
+    
+    if (omniscient || (playerWhosAsking == this))
+        addPrivateInfo(info, playerWhosAsking == this);
+}
+
+void Server_Player::addPrivateInfo(ServerInfo_Player *info, bool withDeckList)
+{
+    if (withDeckList && deck)
+        info->set_deck_list(getDeckListString());
+    
+    // zone_list is in the order of the zones map, see getInfo()
+    int zoneIndex = 0;
+    QMapIterator<QString, Server_CardZone *> zoneIterator(zones);
+    while (zoneIterator.hasNext())
+        zoneIterator.next().value()->addPrivateInfo(info->mutable_zone_list(zoneIndex++));
+}
+
+void Server_Player::removePrivateInfo(ServerInfo_Player *info)
+{
+    info->clear_deck_list();
+    
+    int zoneIndex = 0;
+    QMapIterator<QString, Server_CardZone *> zoneIterator(zones);
+    while (zoneIterator.hasNext())
+        zoneIterator.next().value()->removePrivateInfo(info->mutable_zone_list(zoneIndex++));
+}
+
+const std::string &Server_Player::getDeckListString()
+{
+    if (deckListCache.empty() && deck)
+        deckListCache = deck->writeToString_Native().toStdString();
+    return deckListCache;
 }
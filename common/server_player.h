@@ -68,6 +68,7 @@ private:
     Server_Game *game;
     Server_AbstractUserInterface *userInterface;
     DeckList *deck;
+    std::string deckListCache; // serialized deck, empty if it needs to be rebuilt
     QMap<QString, Server_CardZone *> zones;
     QMap<int, Server_Counter *> counters;
     QMap<int, Server_Arrow *> arrows;
@@ -160,6 +161,11 @@ public:
     void sendGameEvent(const GameEventContainer &event);
     
     void getInfo(ServerInfo_Player *info, Server_Player *playerWhosAsking, bool omniscient, bool withUserInfo);
+    // Turn the public view of this player, as built by getInfo(info, 0, false, ...), into
+    // the view of the owner or an omniscient spectator and back.
+    void addPrivateInfo(ServerInfo_Player *info, bool withDeckList);
+    void removePrivateInfo(ServerInfo_Player *info);
+    const std::string &getDeckListString();
 };
 
 #endif
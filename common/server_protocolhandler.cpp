@@ -31,6 +31,10 @@ Server_ProtocolHandler::Server_ProtocolHandler(Server *_server, Server_DatabaseI
       timeRunning(0),
       lastDataReceived(0)
 {
+    rateLimiter.setBudget(Server_RateLimiter::GameCommandBudget, server->getCommandCountingInterval(), server->getMaxCommandCountPerInterval());
+    rateLimiter.setBudget(Server_RateLimiter::MessageCountBudget, server->getMessageCountingInterval(), server->getMaxMessageCountPerInterval());
+    rateLimiter.setBudget(Server_RateLimiter::MessageSizeBudget, server->getMessageCountingInterval(), server->getMaxMessageSizePerInterval());
+    
     connect(server, SIGNAL(pingClockTimeout()), this, SLOT(pingClockTimeout()));
 }
 
@@ -188,22 +192,6 @@ Response::ResponseCode Server_ProtocolHandler::processRoomCommandContainer(const
 
 Response::ResponseCode Server_ProtocolHandler::processGameCommandContainer(const CommandContainer &cont, ResponseContainer &rc)
 {
-    static QList<GameCommand::GameCommandType> antifloodCommandsWhiteList = QList<GameCommand::GameCommandType>()
-        // draw/undo card draw (example: drawing 10 cards one by one from the deck)
-        << GameCommand::DRAW_CARDS
-        << GameCommand::UNDO_DRAW
-        // create, delete arrows (example: targeting with 10 cards during an attack)
-        << GameCommand::CREATE_ARROW
-        << GameCommand::DELETE_ARROW
-        // set card attributes (example: tapping 10 cards at once)
-        << GameCommand::SET_CARD_ATTR
-        // increment / decrement counter (example: -10 life points one by one)
-        << GameCommand::INC_COUNTER
-        // mulling lots of hands in a row
-        << GameCommand::MULLIGAN
-        // allows a user to sideboard without receiving flooding message
-        << GameCommand::MOVE_CARD;
-
     if (authState == NotLoggedIn)
         return Response::RespLoginNeeded;
     
@@ -237,27 +225,15 @@ Response::ResponseCode Server_ProtocolHandler::processGameCommandContainer(const
     if (!player)
         return Response::RespNotInRoom;
     
-    int commandCountingInterval = server->getCommandCountingInterval();
-    int maxCommandCountPerInterval = server->getMaxCommandCountPerInterval();
     GameEventStorage ges;
     Response::ResponseCode finalResponseCode = Response::RespOk;
     for (int i = cont.game_command_size() - 1; i >= 0; --i) {
         const GameCommand &sc = cont.game_command(i);
         logDebugMessage(QString("game %1 player %2: ").arg(cont.game_id()).arg(roomIdAndPlayerId.second) + QString::fromStdString(sc.ShortDebugString()));
 
-        if (commandCountingInterval > 0) {
-            int totalCount = 0;
-            if (commandCountOverTime.isEmpty())
-                commandCountOverTime.prepend(0);
-
-            if(!antifloodCommandsWhiteList.contains((GameCommand::GameCommandType) getPbExtension(sc)))
-                ++commandCountOverTime[0];
-
-            for (int i = 0; i < commandCountOverTime.size(); ++i)
-                totalCount += commandCountOverTime[i];
-            
-            if (totalCount > maxCommandCountPerInterval)
-                return Response::RespChatFlood;
+        if (!rateLimiter.charge(Server_RateLimiter::GameCommandBudget, Server_RateLimiter::getGameCommandCost(getPbExtension(sc)))) {
+            server->reportFlood(QString::fromStdString(userInfo->name()));
+            return Response::RespChatFlood;
         }
 
         Response::ResponseCode resp = player->processGameCommand(sc, rc, ges);
@@ -342,22 +318,7 @@ void Server_ProtocolHandler::processCommandContainer(const CommandContainer &con
 
 void Server_ProtocolHandler::pingClockTimeout()
 {
-    int interval = server->getMessageCountingInterval();
-    if (interval > 0) {
-        messageSizeOverTime.prepend(0);
-        if (messageSizeOverTime.size() > server->getMessageCountingInterval())
-            messageSizeOverTime.removeLast();
-        messageCountOverTime.prepend(0);
-        if (messageCountOverTime.size() > server->getMessageCountingInterval())
-            messageCountOverTime.removeLast();
-    }
-
-    interval = server->getCommandCountingInterval();
-    if (interval > 0) {
-        commandCountOverTime.prepend(0);
-        if (commandCountOverTime.size() > server->getCommandCountingInterval())
-            commandCountOverTime.removeLast();
-    }
+    rateLimiter.tick();
 
     if (timeRunning - lastDataReceived > server->getMaxPlayerInactivityTime())
         prepareDestroy();
@@ -428,6 +389,9 @@ Response::ResponseCode Server_ProtocolHandler::cmdMessage(const Command_Message
     if (authState == NotLoggedIn)
         return Response::RespLoginNeeded;
     
+    if (!chargeMessage(QString::fromStdString(cmd.message())))
+        return Response::RespChatFlood;
+    
     QReadLocker locker(&server->clientsLock);
     
     QString receiver = QString::fromStdString(cmd.user_name());
@@ -571,27 +535,24 @@ Response::ResponseCode Server_ProtocolHandler::cmdLeaveRoom(const Command_LeaveR
     return Response::RespOk;
 }
 
+bool Server_ProtocolHandler::chargeMessage(const QString &msg)
+{
+    // Room and private chat messages share one budget.
+    const bool sizeOk = rateLimiter.charge(Server_RateLimiter::MessageSizeBudget, msg.size());
+    const bool countOk = rateLimiter.charge(Server_RateLimiter::MessageCountBudget, 1);
+    if (sizeOk && countOk)
+        return true;
+    
+    server->reportFlood(QString::fromStdString(userInfo->name()));
+    return false;
+}
+
 Response::ResponseCode Server_ProtocolHandler::cmdRoomSay(const Command_RoomSay &cmd, Server_Room *room, ResponseContainer & /*rc*/)
 {
     QString msg = QString::fromStdString(cmd.message());
     
-    if (server->getMessageCountingInterval() > 0) {
-        int totalSize = 0, totalCount = 0;
-        if (messageSizeOverTime.isEmpty())
-            messageSizeOverTime.prepend(0);
-        messageSizeOverTime[0] += msg.size();
-        for (int i = 0; i < messageSizeOverTime.size(); ++i)
-            totalSize += messageSizeOverTime[i];
-        
-        if (messageCountOverTime.isEmpty())
-            messageCountOverTime.prepend(0);
-        ++messageCountOverTime[0];
-        for (int i = 0; i < messageCountOverTime.size(); ++i)
-            totalCount += messageCountOverTime[i];
-        
-        if ((totalSize > server->getMaxMessageSizePerInterval()) || (totalCount > server->getMaxMessageCountPerInterval()))
-            return Response::RespChatFlood;
-    }
+    if (!chargeMessage(msg))
+        return Response::RespChatFlood;
     msg.replace(QChar('\n'), QChar(' '));
     
     room->say(QString::fromStdString(userInfo->name()), msg);
@@ -5,6 +5,7 @@
 #include <QPair>
 #include "server.h"
 #include "server_abstractuserinterface.h"
+#include "server_ratelimiter.h"
 #include "pb/response.pb.h"
 #include "pb/server_message.pb.h"
 
@@ -52,7 +53,7 @@ protected:
     bool acceptsRoomListChanges;
     virtual void logDebugMessage(const QString & /* message */) { }
 private:
-    QList<int> messageSizeOverTime, messageCountOverTime, commandCountOverTime;
+    Server_RateLimiter rateLimiter;
     int timeRunning, lastDataReceived;
     QTimer *pingClock;
 
@@ -71,6 +72,8 @@ private:
     Response::ResponseCode cmdCreateGame(const Command_CreateGame &cmd, Server_Room *room, ResponseContainer &rc);
     Response::ResponseCode cmdJoinGame(const Command_JoinGame &cmd, Server_Room *room, ResponseContainer &rc);
     
+    bool chargeMessage(const QString &msg);
+    
     Response::ResponseCode processSessionCommandContainer(const CommandContainer &cont, ResponseContainer &rc);
     virtual Response::ResponseCode processExtendedSessionCommand(int /* cmdType */, const SessionCommand & /* cmd */, ResponseContainer & /* rc */) { return Response::RespFunctionNotAllowed; }
     Response::ResponseCode processRoomCommandContainer(const CommandContainer &cont, ResponseContainer &rc);
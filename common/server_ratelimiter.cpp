@@ -0,0 +1,77 @@
+#include "server_ratelimiter.h"
+#include "pb/game_commands.pb.h"
+
+void Server_SlidingWindow::setLength(int ticks)
+{
+    buckets.fill(0, ticks > 0 ? ticks : 0);
+    currentBucket = 0;
+    total = 0;
+}
+
+void Server_SlidingWindow::add(int amount)
+{
+    if (buckets.isEmpty())
+        return;
+    buckets[currentBucket] += amount;
+    total += amount;
+}
+
+void Server_SlidingWindow::tick()
+{
+    if (buckets.isEmpty())
+        return;
+    if (++currentBucket == buckets.size())
+        currentBucket = 0;
+    total -= buckets[currentBucket];
+    buckets[currentBucket] = 0;
+}
+
+Server_RateLimiter::Server_RateLimiter()
+{
+    for (int i = 0; i < BudgetCount; ++i)
+        limits[i] = 0;
+}
+
+void Server_RateLimiter::setBudget(Budget budget, int intervalTicks, int limit)
+{
+    windows[budget].setLength(intervalTicks);
+    limits[budget] = limit;
+}
+
+bool Server_RateLimiter::charge(Budget budget, int amount)
+{
+    Server_SlidingWindow &window = windows[budget];
+    if (!window.isEnabled())
+        return true;
+    window.add(amount);
+    return window.getTotal() <= limits[budget];
+}
+
+void Server_RateLimiter::tick()
+{
+    for (int i = 0; i < BudgetCount; ++i)
+        windows[i].tick();
+}
+
+int Server_RateLimiter::getGameCommandCost(int commandType)
+{
+    switch (commandType) {
+        // draw/undo card draw (example: drawing 10 cards one by one from the deck)
+        case GameCommand::DRAW_CARDS:
+        case GameCommand::UNDO_DRAW:
+        // create, delete arrows (example: targeting with 10 cards during an attack)
+        case GameCommand::CREATE_ARROW:
+        case GameCommand::DELETE_ARROW:
+        // set card attributes (example: tapping 10 cards at once)
+        case GameCommand::SET_CARD_ATTR:
+        // increment / decrement counter (example: -10 life points one by one)
+        case GameCommand::INC_COUNTER:
+        // mulling lots of hands in a row
+        case GameCommand::MULLIGAN:
+        // allows a user to sideboard without receiving flooding message
+        case GameCommand::MOVE_CARD:
+            return 0;
+        default:
+            return 1;
+    }
+}
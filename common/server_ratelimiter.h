@@ -0,0 +1,42 @@
+#ifndef SERVER_RATELIMITER_H
+#define SERVER_RATELIMITER_H
+
+#include <QVector>
+
+// Sum of the amounts added during the last few ticks of the ping clock.
+// The window is a ring of per-tick buckets with a running total, so both
+// adding and advancing are O(1) regardless of the window length.
+class Server_SlidingWindow {
+private:
+    QVector<int> buckets;
+    int currentBucket;
+    int total;
+public:
+    Server_SlidingWindow() : currentBucket(0), total(0) { }
+    void setLength(int ticks);
+    bool isEnabled() const { return !buckets.isEmpty(); }
+    int getTotal() const { return total; }
+    void add(int amount);
+    void tick();
+};
+
+class Server_RateLimiter {
+public:
+    enum Budget { GameCommandBudget, MessageCountBudget, MessageSizeBudget, BudgetCount };
+private:
+    Server_SlidingWindow windows[BudgetCount];
+    int limits[BudgetCount];
+public:
+    Server_RateLimiter();
+    void setBudget(Budget budget, int intervalTicks, int limit);
+    bool isEnabled(Budget budget) const { return windows[budget].isEnabled(); }
+    // Charges amount to the budget; returns false if the budget is exceeded.
+    bool charge(Budget budget, int amount);
+    void tick();
+
+    // What a game command costs against GameCommandBudget. Commands that are
+    // routinely sent in quick succession during normal play are free.
+    static int getGameCommandCost(int commandType);
+};
+
+#endif
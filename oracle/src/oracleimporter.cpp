@@ -5,7 +5,11 @@
     #include <QtWidgets>
 #endif
 #include <QDebug>
+#if QT_VERSION >= 0x050000
+    #include <QtConcurrent>
+#endif
 
+#include "setsjsonstream.h"
 #include "qt-json/json.h"
 
 OracleImporter::OracleImporter(const QString &_dataDir, QObject *parent)
@@ -15,38 +19,24 @@ OracleImporter::OracleImporter(const QString &_dataDir, QObject *parent)
 
 bool OracleImporter::readSetsFromByteArray(const QByteArray &data)
 {
-    QList<SetToDownload> newSetList;
-    
-    bool ok;
-    setsMap = QtJson::Json::parse(QString(data), ok).toMap();
-    if (!ok) {
-        qDebug() << "error: QtJson::Json::parse()";
-        return 0;
-    }
-    
-    QListIterator<QVariant> it(setsMap.values());
-    QVariantMap map;
-
-    QString edition;
-    QString editionLong;
-    QVariant editionCards;
-    QString setType;
-    QDate releaseDate;
+    // feed the stream in chunks, so that it never buffers more than a set
+    const int chunkSize = 1024 * 1024;
+    SetsJsonStream stream;
+    for (int pos = 0; pos < data.size(); pos += chunkSize)
+        if (stream.write(data.constData() + pos, qMin(chunkSize, data.size() - pos)) == -1)
+            break;
+
+    return readSetsFromStream(stream);
+}
 
-    while (it.hasNext()) {
-        map = it.next().toMap();
-        edition = map.value("code").toString();
-        editionLong = map.value("name").toString();
-        editionCards = map.value("cards");
-        setType = map.value("type").toString();
-        // capitalize set type
-        if(setType.length() > 0)
-            setType[0] = setType[0].toUpper();
-        releaseDate = map.value("releaseDate").toDate();
-
-        newSetList.append(SetToDownload(edition, editionLong, editionCards, setType, releaseDate));
+bool OracleImporter::readSetsFromStream(SetsJsonStream &stream)
+{
+    if (!stream.isComplete()) {
+        qDebug() << "error: SetsJsonStream: incomplete or invalid document";
+        return false;
     }
 
+    QList<SetToDownload> newSetList = stream.takeSets();
     qSort(newSetList);
 
     if (newSetList.isEmpty())
@@ -132,10 +122,17 @@ void OracleImporter::extractColors(const QStringList & in, QStringList & out)
     }
 }
 
-int OracleImporter::importTextSpoiler(CardSet *set, const QVariant &data)
+QList<CardToImport> OracleImporter::convertCards(const SetToDownload &set)
 {
-    int cards = 0;
-    
+    QList<CardToImport> result;
+
+    bool ok;
+    const QVariant data = QtJson::Json::parse(QString::fromUtf8(set.getCards()), ok);
+    if (!ok) {
+        qDebug() << "error: QtJson::Json::parse(): cards of set" << set.getShortName();
+        return result;
+    }
+
     QListIterator<QVariant> it(data.toList());
     QVariantMap map;
     QString cardName;
@@ -192,12 +189,19 @@ int OracleImporter::importTextSpoiler(CardSet *set, const QVariant &data)
         colors.clear();
         extractColors(map.value("colors").toStringList(), colors);
 
-        CardInfo *card = addCard(set->getShortName(), cardName, false, cardId, cardCost, cmc, cardType, cardPT, cardLoyalty, cardText, colors, relatedCards, upsideDown);
-
-        if (!set->contains(card)) {
-            card->addToSet(set);
-            cards++;
-        }
+        CardToImport card;
+        card.name = cardName;
+        card.cost = cardCost;
+        card.cmc = cmc;
+        card.type = cardType;
+        card.pt = cardPT;
+        card.text = cardText;
+        card.colors = colors;
+        card.relatedCards = relatedCards;
+        card.muId = cardId;
+        card.loyalty = cardLoyalty;
+        card.upsideDown = upsideDown;
+        result.append(card);
     }
     
     // split cards handling - get all unique card muids
@@ -279,13 +283,36 @@ int OracleImporter::importTextSpoiler(CardSet *set, const QVariant &data)
         upsideDown = false;
 
         // add the card
-        CardInfo *card = addCard(set->getShortName(), cardName, false, muid, cardCost, cmc, cardType, cardPT, cardLoyalty, cardText, colors, relatedCards, upsideDown);
+        CardToImport card;
+        card.name = cardName;
+        card.cost = cardCost;
+        card.cmc = cmc;
+        card.type = cardType;
+        card.pt = cardPT;
+        card.text = cardText;
+        card.colors = colors;
+        card.relatedCards = relatedCards;
+        card.muId = muid;
+        card.loyalty = cardLoyalty;
+        card.upsideDown = upsideDown;
+        result.append(card);
+    }
+
+    return result;
+}
+
+int OracleImporter::importTextSpoiler(CardSet *set, const QList<CardToImport> &cardsToImport)
+{
+    int cards = 0;
+
+    for (int i = 0; i < cardsToImport.size(); ++i) {
+        CardToImport cardToImport = cardsToImport[i];
+        CardInfo *card = addCard(set->getShortName(), cardToImport.name, false, cardToImport.muId, cardToImport.cost, cardToImport.cmc, cardToImport.type, cardToImport.pt, cardToImport.loyalty, cardToImport.text, cardToImport.colors, cardToImport.relatedCards, cardToImport.upsideDown);
 
         if (!set->contains(card)) {
             card->addToSet(set);
             cards++;
         }
-
     }
 
     return cards;
@@ -303,6 +330,10 @@ int OracleImporter::startImport()
     CardSet *tokenSet = new CardSet(TOKENS_SETNAME, tr("Dummy set containing tokens"), "Tokens");
     sets.insert(TOKENS_SETNAME, tokenSet);
 
+    // The cards of the sets are converted on the thread pool; they are added
+    // here in the order of the sets, because the first set of a card wins.
+    QFuture<QList<CardToImport> > convertedCards = QtConcurrent::mapped(allSets, &OracleImporter::convertCards);
+
     while (it.hasNext())
     {
         curSet = & it.next();            
@@ -310,7 +341,7 @@ int OracleImporter::startImport()
         if (!sets.contains(set->getShortName()))
             sets.insert(set->getShortName(), set);
 
-        int setCards = importTextSpoiler(set, curSet->getCards());
+        int setCards = importTextSpoiler(set, convertedCards.resultAt(setIndex));
 
         ++setIndex;
             
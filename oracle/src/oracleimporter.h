@@ -5,30 +5,43 @@
 
 #include <carddatabase.h>
 
+class SetsJsonStream;
+
 class SetToDownload {
 private:
     QString shortName, longName;
-    QVariant cards;
+    // the JSON array of the cards, converted when the set is imported
+    QByteArray cards;
     QDate releaseDate;
     QString setType;
 public:
     const QString &getShortName() const { return shortName; }
     const QString &getLongName() const { return longName; }
-    const QVariant &getCards() const { return cards; }
+    const QByteArray &getCards() const { return cards; }
     const QString &getSetType() const { return setType; }
     const QDate &getReleaseDate() const { return releaseDate; }
-    SetToDownload(const QString &_shortName, const QString &_longName, const QVariant &_cards, const QString &_setType = QString(), const QDate &_releaseDate = QDate())
+    SetToDownload(const QString &_shortName, const QString &_longName, const QByteArray &_cards, const QString &_setType = QString(), const QDate &_releaseDate = QDate())
         : shortName(_shortName), longName(_longName), cards(_cards), releaseDate(_releaseDate), setType(_setType)  { }
     bool operator<(const SetToDownload &set) const { return longName.compare(set.longName, Qt::CaseInsensitive) < 0; }
 };
 
+// The properties of a card as read from the JSON, before it is added to the database.
+class CardToImport {
+public:
+    QString name, cost, cmc, type, pt, text;
+    QStringList colors, relatedCards;
+    int muId, loyalty;
+    bool upsideDown;
+    CardToImport() : muId(0), loyalty(0), upsideDown(false) { }
+};
+
 class OracleImporter : public CardDatabase {
     Q_OBJECT
 private:
     QList<SetToDownload> allSets;
-    QVariantMap setsMap;
     QString dataDir;
-    
+
+    static QList<CardToImport> convertCards(const SetToDownload &set);
     CardInfo *addCard(const QString &setName, QString cardName, bool isToken, int cardId, QString &cardCost, QString &cmc, const QString &cardType, const QString &cardPT, int cardLoyalty, const QString &cardText, const QStringList & colors, const QStringList & relatedCards, bool upsideDown);
 signals:
     void setIndexChanged(int cardsImported, int setIndex, const QString &setName);
@@ -36,12 +49,14 @@ signals:
 public:
     OracleImporter(const QString &_dataDir, QObject *parent = 0);
     bool readSetsFromByteArray(const QByteArray &data);
+    // Takes the sets of a stream which the whole file has been written into.
+    bool readSetsFromStream(SetsJsonStream &stream);
     int startImport();
-    int importTextSpoiler(CardSet *set, const QVariant &data);
+    int importTextSpoiler(CardSet *set, const QList<CardToImport> &cardsToImport);
     QList<SetToDownload> &getSets() { return allSets; }
     const QString &getDataDir() const { return dataDir; }
 protected:
-    void extractColors(const QStringList & in, QStringList & out);
+    static void extractColors(const QStringList & in, QStringList & out);
 };
 
 #endif
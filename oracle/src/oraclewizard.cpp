@@ -26,6 +26,7 @@
 
 #include "oraclewizard.h"
 #include "oracleimporter.h"
+#include "setsjsonstream.h"
 #include "main.h"
 #include "settingscache.h"
 
@@ -41,6 +42,33 @@
 
 #define TOKENS_URL "https://raw.githubusercontent.com/Cockatrice/Magic-Token/master/tokens.xml"
 
+#ifdef HAS_ZLIB
+// Extracts the sets file straight into a stream reading it, so that the
+// uncompressed file is never held in memory as a whole.
+// If the archive cannot be extracted, the reason is stored in zipError.
+static bool readSetsFromZipArchive(OracleImporter *importer, QByteArray data, QString fileName, QString *zipError)
+{
+    QBuffer inBuffer(&data);
+    UnZip uz;
+    UnZip::ErrorCode ec = uz.openArchive(&inBuffer);
+    if (ec != UnZip::Ok) {
+        *zipError = uz.formatError(ec);
+        return false;
+    }
+
+    SetsJsonStream stream;
+    ec = uz.extractFile(fileName, &stream);
+    uz.closeArchive();
+    if (ec != UnZip::Ok) {
+        qDebug() << "Zip extraction failed:" << uz.formatError(ec);
+        *zipError = uz.formatError(ec);
+        return false;
+    }
+
+    return importer->readSetsFromStream(stream);
+}
+#endif
+
 
 OracleWizard::OracleWizard(QWidget *parent)
     : QWizard(parent)
@@ -369,13 +397,12 @@ void LoadSetsPage::readSetsFromByteArray(QByteArray data)
     {
 #ifdef HAS_ZLIB
         // zipped file
-        QBuffer *inBuffer = new QBuffer(&data);
-        QBuffer *outBuffer = new QBuffer(this);
+        QBuffer inBuffer(&data);
         QString fileName;
         UnZip::ErrorCode ec;
         UnZip uz;
 
-        ec = uz.openArchive(inBuffer);
+        ec = uz.openArchive(&inBuffer);
         if (ec != UnZip::Ok) {
             zipDownloadFailed(tr("Failed to open Zip archive: %1.").arg(uz.formatError(ec)));
             return;
@@ -387,16 +414,11 @@ void LoadSetsPage::readSetsFromByteArray(QByteArray data)
             return;            
         }
         fileName = uz.fileList().at(0);
+        uz.closeArchive();
 
-        outBuffer->open(QBuffer::ReadWrite);
-        ec = uz.extractFile(fileName, outBuffer);
-        if (ec != UnZip::Ok) {
-            zipDownloadFailed(tr("Zip extraction failed: %1.").arg(uz.formatError(ec)));
-            uz.closeArchive();
-            return;
-        }
-
-        future = QtConcurrent::run(wizard()->importer, &OracleImporter::readSetsFromByteArray, outBuffer->data());
+        // the archive is extracted and parsed together, off the GUI thread
+        zipError.clear();
+        future = QtConcurrent::run(readSetsFromZipArchive, wizard()->importer, data, fileName, &zipError);
         watcher.setFuture(future);
         return;
 #else
@@ -410,6 +432,7 @@ void LoadSetsPage::readSetsFromByteArray(QByteArray data)
 #endif
     } 
     // Start the computation.
+    zipError.clear();
     future = QtConcurrent::run(wizard()->importer, &OracleImporter::readSetsFromByteArray, data);
     watcher.setFuture(future);
 }
@@ -442,6 +465,8 @@ void LoadSetsPage::importFinished()
     if(watcher.future().result())
     {
         wizard()->next();
+    } else if (!zipError.isEmpty()) {
+        zipDownloadFailed(tr("Zip extraction failed: %1.").arg(zipError));
     } else {
         QMessageBox::critical(this, tr("Error"), tr("The file was retrieved successfully, but it does not contain any sets data."));
     }
@@ -93,6 +93,8 @@ private:
      QNetworkAccessManager *nam;
      QFutureWatcher<bool> watcher;
      QFuture<bool> future;
+     // set by the import when a zipped file could not be extracted
+     QString zipError;
 private slots:
      void actLoadSetsFile();
      void actRestoreDefaultUrl();
@@ -0,0 +1,203 @@
+#include "setsjsonstream.h"
+#include <QDebug>
+
+#include "qt-json/json.h"
+
+static bool isJsonSpace(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+}
+
+static int skipSpace(const QByteArray &json, int pos)
+{
+    while ((pos < json.size()) && isJsonSpace(json[pos]))
+        ++pos;
+    return pos;
+}
+
+// Returns the position after the string starting at pos, or -1.
+static int skipString(const QByteArray &json, int pos)
+{
+    for (++pos; pos < json.size(); ++pos) {
+        if (json[pos] == '\\')
+            ++pos;
+        else if (json[pos] == '"')
+            return pos + 1;
+    }
+    return -1;
+}
+
+// Returns the position after the value starting at pos, or -1.
+static int skipValue(const QByteArray &json, int pos)
+{
+    if (pos >= json.size())
+        return -1;
+
+    const char first = json[pos];
+    if (first == '"')
+        return skipString(json, pos);
+
+    if ((first == '{') || (first == '[')) {
+        int depth = 0;
+        while (pos < json.size()) {
+            const char c = json[pos];
+            if (c == '"') {
+                pos = skipString(json, pos);
+                if (pos == -1)
+                    return -1;
+                continue;
+            }
+            if ((c == '{') || (c == '['))
+                ++depth;
+            else if (((c == '}') || (c == ']')) && (--depth == 0))
+                return pos + 1;
+            ++pos;
+        }
+        return -1;
+    }
+
+    // numbers, true, false and null
+    while ((pos < json.size()) && (json[pos] != ',') && (json[pos] != '}') && (json[pos] != ']') && !isJsonSpace(json[pos]))
+        ++pos;
+    return pos;
+}
+
+SetsJsonStream::SetsJsonStream(QObject *parent)
+    : QIODevice(parent), state(BeforeDocument), scanPos(0), depth(0), setStart(-1), inString(false), escaped(false)
+{
+    open(QIODevice::WriteOnly);
+}
+
+QList<SetToDownload> SetsJsonStream::takeSets()
+{
+    QList<SetToDownload> result = sets;
+    sets.clear();
+    return result;
+}
+
+qint64 SetsJsonStream::readData(char * /* data */, qint64 /* maxSize */)
+{
+    return -1;
+}
+
+qint64 SetsJsonStream::writeData(const char *data, qint64 maxSize)
+{
+    if (state == Failed)
+        return -1;
+    if (state == AfterDocument)
+        return maxSize;
+
+    buffer.append(data, (int) maxSize);
+
+    for (; scanPos < buffer.size(); ++scanPos) {
+        const char c = buffer[scanPos];
+
+        if (state == BeforeDocument) {
+            // skip the byte order mark and white space before the document
+            if (isJsonSpace(c) || ((unsigned char) c == 0xef) || ((unsigned char) c == 0xbb) || ((unsigned char) c == 0xbf))
+                continue;
+            if (c != '{') {
+                qDebug() << "SetsJsonStream: the document is not an object";
+                state = Failed;
+                return -1;
+            }
+            state = InDocument;
+            depth = 1;
+            continue;
+        }
+        if (state == AfterDocument)
+            break;
+
+        if (inString) {
+            if (escaped)
+                escaped = false;
+            else if (c == '\\')
+                escaped = true;
+            else if (c == '"')
+                inString = false;
+            continue;
+        }
+
+        if (c == '"')
+            inString = true;
+        else if ((c == '{') || (c == '[')) {
+            if ((depth == 1) && (c == '{'))
+                setStart = scanPos;
+            ++depth;
+        } else if ((c == '}') || (c == ']')) {
+            if ((--depth == 1) && (setStart != -1)) {
+                if (!readSet(buffer.mid(setStart, scanPos - setStart + 1))) {
+                    state = Failed;
+                    return -1;
+                }
+                setStart = -1;
+            } else if (depth == 0)
+                state = AfterDocument;
+        }
+    }
+
+    // keep only the part of the current set which has been written so far
+    if (setStart == -1)
+        buffer.clear();
+    else {
+        buffer.remove(0, setStart);
+        setStart = 0;
+    }
+    scanPos = buffer.size();
+
+    return maxSize;
+}
+
+bool SetsJsonStream::readSet(const QByteArray &json)
+{
+    QString edition, editionLong, setType;
+    QDate releaseDate;
+    QByteArray editionCards;
+
+    int pos = skipSpace(json, 1);
+    while ((pos < json.size()) && (json[pos] != '}')) {
+        if (json[pos] != '"')
+            return false;
+        const int keyEnd = skipString(json, pos);
+        if (keyEnd == -1)
+            return false;
+        const QByteArray key = json.mid(pos + 1, keyEnd - pos - 2);
+
+        pos = skipSpace(json, keyEnd);
+        if ((pos >= json.size()) || (json[pos] != ':'))
+            return false;
+        const int valueStart = skipSpace(json, pos + 1);
+        const int valueEnd = skipValue(json, valueStart);
+        if (valueEnd == -1)
+            return false;
+
+        // the cards are converted when the set is imported
+        if (key == "cards")
+            editionCards = json.mid(valueStart, valueEnd - valueStart);
+        else if ((key == "code") || (key == "name") || (key == "type") || (key == "releaseDate")) {
+            bool ok;
+            const QVariant value = QtJson::Json::parse(QString::fromUtf8(json.constData() + valueStart, valueEnd - valueStart), ok);
+            if (!ok)
+                return false;
+            if (key == "code")
+                edition = value.toString();
+            else if (key == "name")
+                editionLong = value.toString();
+            else if (key == "type")
+                setType = value.toString();
+            else
+                releaseDate = value.toDate();
+        }
+
+        pos = skipSpace(json, valueEnd);
+        if ((pos < json.size()) && (json[pos] == ','))
+            pos = skipSpace(json, pos + 1);
+    }
+
+    // capitalize set type
+    if(setType.length() > 0)
+        setType[0] = setType[0].toUpper();
+
+    sets.append(SetToDownload(edition, editionLong, editionCards, setType, releaseDate));
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef SETSJSONSTREAM_H
+#define SETSJSONSTREAM_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+
+#include "oracleimporter.h"
+
+/*
+ * Reads an AllSets.json file while it is being written into it, one set at
+ * a time. Only the bytes of the current set are buffered; its properties
+ * are parsed right away, while the cards are kept as raw JSON so that they
+ * can be converted later, when the set is imported.
+ */
+class SetsJsonStream : public QIODevice {
+private:
+    enum State { BeforeDocument, InDocument, AfterDocument, Failed };
+
+    State state;
+    QByteArray buffer;
+    int scanPos;
+    // the nesting depth and the start of the current set in the buffer
+    int depth;
+    int setStart;
+    bool inString, escaped;
+    QList<SetToDownload> sets;
+
+    bool readSet(const QByteArray &json);
+protected:
+    qint64 readData(char *data, qint64 maxSize);
+    qint64 writeData(const char *data, qint64 maxSize);
+public:
+    SetsJsonStream(QObject *parent = 0);
+
+    // True once the whole document has been written without errors.
+    bool isComplete() const { return state == AfterDocument; }
+    QList<SetToDownload> takeSets();
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "isl_interface.h"
+#include "isl_replicator.h"
 #include <QSslSocket>
 #include "server_logger.h"
 #include "main.h"
@@ -16,10 +17,127 @@
 #include "pb/event_leave_room.pb.h"
 #include "pb/event_room_say.pb.h"
 #include "pb/event_list_games.pb.h"
+#include "pb/room_commands.pb.h"
 #include <google/protobuf/descriptor.h>
 
+class IslTask_UserJoined : public IslReplicationTask {
+private:
+	ServerInfo_User userInfo;
+public:
+	IslTask_UserJoined(const ServerInfo_User &_userInfo) : userInfo(_userInfo) { }
+	void run(Server *server) { server->externalUserJoined(userInfo); }
+};
+
+class IslTask_UserLeft : public IslReplicationTask {
+private:
+	QString userName;
+public:
+	IslTask_UserLeft(const QString &_userName) : userName(_userName) { }
+	void run(Server *server) { server->externalUserLeft(userName); }
+};
+
+class IslTask_RoomUserJoined : public IslReplicationTask {
+private:
+	int roomId;
+	ServerInfo_User userInfo;
+public:
+	IslTask_RoomUserJoined(int _roomId, const ServerInfo_User &_userInfo) : roomId(_roomId), userInfo(_userInfo) { }
+	void run(Server *server) { server->externalRoomUserJoined(roomId, userInfo); }
+};
+
+class IslTask_RoomUserLeft : public IslReplicationTask {
+private:
+	int roomId;
+	QString userName;
+public:
+	IslTask_RoomUserLeft(int _roomId, const QString &_userName) : roomId(_roomId), userName(_userName) { }
+	void run(Server *server) { server->externalRoomUserLeft(roomId, userName); }
+};
+
+class IslTask_RoomSay : public IslReplicationTask {
+private:
+	int roomId;
+	QString userName, message;
+public:
+	IslTask_RoomSay(int _roomId, const QString &_userName, const QString &_message) : roomId(_roomId), userName(_userName), message(_message) { }
+	void run(Server *server) { server->externalRoomSay(roomId, userName, message); }
+};
+
+class IslTask_RoomGameListChanged : public IslReplicationTask {
+private:
+	int roomId;
+	ServerInfo_Game gameInfo;
+public:
+	IslTask_RoomGameListChanged(int _roomId, const ServerInfo_Game &_gameInfo) : roomId(_roomId), gameInfo(_gameInfo) { }
+	void run(Server *server) { server->externalRoomGameListChanged(roomId, gameInfo); }
+};
+
+class IslTask_JoinGameCommand : public IslReplicationTask {
+private:
+	Command_JoinGame cmd;
+	int cmdId, roomId, serverId;
+	qint64 sessionId;
+public:
+	IslTask_JoinGameCommand(const Command_JoinGame &_cmd, int _cmdId, int _roomId, int _serverId, qint64 _sessionId)
+		: cmd(_cmd), cmdId(_cmdId), roomId(_roomId), serverId(_serverId), sessionId(_sessionId) { }
+	void run(Server *server) { server->externalJoinGameCommandReceived(cmd, cmdId, roomId, serverId, sessionId); }
+};
+
+class IslTask_GameCommandContainer : public IslReplicationTask {
+private:
+	CommandContainer cont;
+	int playerId, serverId;
+	qint64 sessionId;
+public:
+	IslTask_GameCommandContainer(const CommandContainer &_cont, int _playerId, int _serverId, qint64 _sessionId)
+		: cont(_cont), playerId(_playerId), serverId(_serverId), sessionId(_sessionId) { }
+	void run(Server *server) { server->externalGameCommandContainerReceived(cont, playerId, serverId, sessionId); }
+};
+
+class IslTask_Response : public IslReplicationTask {
+private:
+	Response resp;
+	qint64 sessionId;
+public:
+	IslTask_Response(const Response &_resp, qint64 _sessionId) : resp(_resp), sessionId(_sessionId) { }
+	void run(Server *server) { server->externalResponseReceived(resp, sessionId); }
+};
+
+class IslTask_GameEventContainer : public IslReplicationTask {
+private:
+	GameEventContainer cont;
+	qint64 sessionId;
+public:
+	IslTask_GameEventContainer(const GameEventContainer &_cont, qint64 _sessionId) : cont(_cont), sessionId(_sessionId) { }
+	void run(Server *server) { server->externalGameEventContainerReceived(cont, sessionId); }
+};
+
+class IslTask_SessionEvent : public IslReplicationTask {
+private:
+	SessionEvent event;
+	qint64 sessionId;
+public:
+	IslTask_SessionEvent(const SessionEvent &_event, qint64 _sessionId) : event(_event), sessionId(_sessionId) { }
+	void run(Server *server)
+	{
+		QReadLocker clientsLocker(&server->clientsLock);
+		Server_AbstractUserInterface *client = server->getUsersBySessionId().value(sessionId);
+		if (!client) {
+			qDebug() << "IslTask_SessionEvent: session id" << sessionId << "not found";
+			return;
+		}
+		if (getPbExtension(event) == SessionEvent::GAME_JOINED) {
+			const Event_GameJoined &gameJoined = event.GetExtension(Event_GameJoined::ext);
+			client->playerAddedToGame(gameJoined.game_info().game_id(), gameJoined.game_info().room_id(), gameJoined.player_id());
+		}
+		client->sendProtocolItem(event);
+	}
+};
+
 void IslInterface::sharedCtor(const QSslCertificate &cert, const QSslKey &privateKey)
 {
+	replicator = server->getIslReplicator();
+	
 	socket = new QSslSocket(this);
 	socket->setLocalCertificate(cert);
 	socket->setPrivateKey(privateKey);
@@ -47,9 +165,11 @@ IslInterface::~IslInterface()
 	
 	flushOutputBuffer();
 	
-	// As these signals are connected with Qt::QueuedConnection implicitly,
-	// we don't need to worry about them modifying the lists while we're iterating.
+	// The replication threads take roomsLock and clientsLock for writing, and
+	// enqueueing blocks while the peer's backlog is full, so the users are
+	// collected under the locks first and their removal is enqueued afterwards.
 	
+	QList<QPair<int, QString> > roomUsersLeft;
 	server->roomsLock.lockForRead();
 	QMapIterator<int, Server_Room *> roomIterator(server->getRooms());
 	while (roomIterator.hasNext()) {
@@ -59,20 +179,26 @@ IslInterface::~IslInterface()
 		while (roomUsers.hasNext()) {
 			roomUsers.next();
 			if (roomUsers.value().getUserInfo()->server_id() == serverId)
-				emit externalRoomUserLeft(room->getId(), roomUsers.key());
+				roomUsersLeft.append(QPair<int, QString>(room->getId(), roomUsers.key()));
 		}
 		room->usersLock.unlock();
 	}
 	server->roomsLock.unlock();
 	
+	QList<QPair<QString, qint64> > usersLeft;
 	server->clientsLock.lockForRead();
 	QMapIterator<QString, Server_AbstractUserInterface *> extUsers(server->getExternalUsers());
 	while (extUsers.hasNext()) {
 		extUsers.next();
 		if (extUsers.value()->getUserInfo()->server_id() == serverId)
-			emit externalUserLeft(extUsers.key());
+			usersLeft.append(QPair<QString, qint64>(extUsers.key(), extUsers.value()->getUserInfo()->session_id()));
 	}
 	server->clientsLock.unlock();
+	
+	for (int i = 0; i < roomUsersLeft.size(); ++i)
+		replicator->enqueueForRoom(serverId, roomUsersLeft[i].first, new IslTask_RoomUserLeft(roomUsersLeft[i].first, roomUsersLeft[i].second));
+	for (int i = 0; i < usersLeft.size(); ++i)
+		externalUserLeft(usersLeft[i].first, usersLeft[i].second);
 }
 
 void IslInterface::initServer()
@@ -260,24 +386,36 @@ void IslInterface::transmitMessage(const IslMessage &item)
 	emit outputBufferChanged();
 }
 
+void IslInterface::externalUserJoined(const ServerInfo_User &userInfo)
+{
+	userSessionIds.insert(QString::fromStdString(userInfo.name()), userInfo.session_id());
+	replicator->enqueueForSession(serverId, userInfo.session_id(), new IslTask_UserJoined(userInfo));
+}
+
+void IslInterface::externalUserLeft(const QString &userName, qint64 sessionId)
+{
+	userSessionIds.remove(userName);
+	replicator->enqueueForSession(serverId, sessionId, new IslTask_UserLeft(userName));
+}
+
 void IslInterface::sessionEvent_ServerCompleteList(const Event_ServerCompleteList &event)
 {
 	for (int i = 0; i < event.user_list_size(); ++i) {
 		ServerInfo_User temp(event.user_list(i));
 		temp.set_server_id(serverId);
-		emit externalUserJoined(temp);
+		externalUserJoined(temp);
 	}
 	for (int i = 0; i < event.room_list_size(); ++i) {
 		const ServerInfo_Room &room = event.room_list(i);
 		for (int j = 0; j < room.user_list_size(); ++j) {
 			ServerInfo_User userInfo(room.user_list(j));
 			userInfo.set_server_id(serverId);
-			emit externalRoomUserJoined(room.room_id(), userInfo);
+			replicator->enqueueForRoom(serverId, room.room_id(), new IslTask_RoomUserJoined(room.room_id(), userInfo));
 		}
 		for (int j = 0; j < room.game_list_size(); ++j) {
 			ServerInfo_Game gameInfo(room.game_list(j));
 			gameInfo.set_server_id(serverId);
-			emit externalRoomGameListChanged(room.room_id(), gameInfo);
+			replicator->enqueueForRoom(serverId, room.room_id(), new IslTask_RoomGameListChanged(room.room_id(), gameInfo));
 		}
 	}
 }
@@ -286,29 +424,30 @@ void IslInterface::sessionEvent_UserJoined(const Event_UserJoined &event)
 {
 	ServerInfo_User userInfo(event.user_info());
 	userInfo.set_server_id(serverId);
-	emit externalUserJoined(userInfo);
+	externalUserJoined(userInfo);
 }
 
 void IslInterface::sessionEvent_UserLeft(const Event_UserLeft &event)
 {
-	emit externalUserLeft(QString::fromStdString(event.name()));
+	const QString userName = QString::fromStdString(event.name());
+	externalUserLeft(userName, userSessionIds.value(userName));
 }
 
 void IslInterface::roomEvent_UserJoined(int roomId, const Event_JoinRoom &event)
 {
 	ServerInfo_User userInfo(event.user_info());
 	userInfo.set_server_id(serverId);
-	emit externalRoomUserJoined(roomId, userInfo);
+	replicator->enqueueForRoom(serverId, roomId, new IslTask_RoomUserJoined(roomId, userInfo));
 }
 
 void IslInterface::roomEvent_UserLeft(int roomId, const Event_LeaveRoom &event)
 {
-	emit externalRoomUserLeft(roomId, QString::fromStdString(event.name()));
+	replicator->enqueueForRoom(serverId, roomId, new IslTask_RoomUserLeft(roomId, QString::fromStdString(event.name())));
 }
 
 void IslInterface::roomEvent_Say(int roomId, const Event_RoomSay &event)
 {
-	emit externalRoomSay(roomId, QString::fromStdString(event.name()), QString::fromStdString(event.message()));
+	replicator->enqueueForRoom(serverId, roomId, new IslTask_RoomSay(roomId, QString::fromStdString(event.name()), QString::fromStdString(event.message())));
 }
 
 void IslInterface::roomEvent_ListGames(int roomId, const Event_ListGames &event)
@@ -316,13 +455,13 @@ void IslInterface::roomEvent_ListGames(int roomId, const Event_ListGames &event)
 	for (int i = 0; i < event.game_list_size(); ++i) {
 		ServerInfo_Game gameInfo(event.game_list(i));
 		gameInfo.set_server_id(serverId);
-		emit externalRoomGameListChanged(roomId, gameInfo);
+		replicator->enqueueForRoom(serverId, roomId, new IslTask_RoomGameListChanged(roomId, gameInfo));
 	}
 }
 
 void IslInterface::roomCommand_JoinGame(const Command_JoinGame &cmd, int cmdId, int roomId, qint64 sessionId)
 {
-	emit joinGameCommandReceived(cmd, cmdId, roomId, serverId, sessionId);
+	replicator->enqueueForSession(serverId, sessionId, new IslTask_JoinGameCommand(cmd, cmdId, roomId, serverId, sessionId));
 }
 
 void IslInterface::processSessionEvent(const SessionEvent &event, qint64 sessionId)
@@ -331,30 +470,9 @@ void IslInterface::processSessionEvent(const SessionEvent &event, qint64 session
 		case SessionEvent::SERVER_COMPLETE_LIST: sessionEvent_ServerCompleteList(event.GetExtension(Event_ServerCompleteList::ext)); break;
 		case SessionEvent::USER_JOINED: sessionEvent_UserJoined(event.GetExtension(Event_UserJoined::ext)); break;
 		case SessionEvent::USER_LEFT: sessionEvent_UserLeft(event.GetExtension(Event_UserLeft::ext)); break;
-		case SessionEvent::GAME_JOINED: {
-			QReadLocker clientsLocker(&server->clientsLock);
-			Server_AbstractUserInterface *client = server->getUsersBySessionId().value(sessionId);
-			if (!client) {
-				qDebug() << "IslInterface::processSessionEvent: session id" << sessionId << "not found";
-				break;
-			}
-			const Event_GameJoined &gameJoined = event.GetExtension(Event_GameJoined::ext);
-			client->playerAddedToGame(gameJoined.game_info().game_id(), gameJoined.game_info().room_id(), gameJoined.player_id());
-			client->sendProtocolItem(event);
-			break;
-		}
+		case SessionEvent::GAME_JOINED:
 		case SessionEvent::USER_MESSAGE:
-		case SessionEvent::REPLAY_ADDED: {
-			QReadLocker clientsLocker(&server->clientsLock);
-			Server_AbstractUserInterface *client = server->getUsersBySessionId().value(sessionId);
-			if (!client) {
-				qDebug() << "IslInterface::processSessionEvent: session id" << sessionId << "not found";
-				break;
-			}
-			
-			client->sendProtocolItem(event);
-			break;
-		}
+		case SessionEvent::REPLAY_ADDED: replicator->enqueueForSession(serverId, sessionId, new IslTask_SessionEvent(event, sessionId)); break;
 		default: ;
 	}
 }
@@ -391,7 +509,7 @@ void IslInterface::processMessage(const IslMessage &item)
 			break;
 		}
 		case IslMessage::GAME_COMMAND_CONTAINER: {
-			emit gameCommandContainerReceived(item.game_command(), item.player_id(), serverId, item.session_id());
+			replicator->enqueueForSession(serverId, item.session_id(), new IslTask_GameCommandContainer(item.game_command(), item.player_id(), serverId, item.session_id()));
 			break;
 		}
 		case IslMessage::SESSION_EVENT: {
@@ -399,11 +517,11 @@ void IslInterface::processMessage(const IslMessage &item)
 			break;
 		}
 		case IslMessage::RESPONSE: {
-			emit responseReceived(item.response(), item.session_id());
+			replicator->enqueueForSession(serverId, item.session_id(), new IslTask_Response(item.response(), item.session_id()));
 			break;
 		}
 		case IslMessage::GAME_EVENT_CONTAINER: {
-			emit gameEventContainerReceived(item.game_event_container(), item.session_id());
+			replicator->enqueueForSession(serverId, item.session_id(), new IslTask_GameEventContainer(item.game_event_container(), item.session_id()));
 			break;
 		}
 		case IslMessage::ROOM_EVENT: {
@@ -4,11 +4,13 @@
 #include "servatrice.h"
 #include <QSslCertificate>
 #include <QWaitCondition>
+#include <QHash>
 #include "pb/serverinfo_user.pb.h"
 #include "pb/serverinfo_room.pb.h"
 #include "pb/serverinfo_game.pb.h"
 
 class Servatrice;
+class IslReplicator;
 class QSslSocket;
 class QSslKey;
 class IslMessage;
@@ -31,17 +33,6 @@ private slots:
 	void flushOutputBuffer();
 signals:
 	void outputBufferChanged();
-	
-	void externalUserJoined(ServerInfo_User userInfo);
-	void externalUserLeft(QString userName);
-	void externalRoomUserJoined(int roomId, ServerInfo_User userInfo);
-	void externalRoomUserLeft(int roomId, QString userName);
-	void externalRoomSay(int roomId, QString userName, QString message);
-	void externalRoomGameListChanged(int roomId, ServerInfo_Game gameInfo);
-	void joinGameCommandReceived(const Command_JoinGame &cmd, int cmdId, int roomId, int serverId, qint64 sessionId);
-	void gameCommandContainerReceived(const CommandContainer &cont, int playerId, int serverId, qint64 sessionId);
-	void responseReceived(const Response &resp, qint64 sessionId);
-	void gameEventContainerReceived(const GameEventContainer &cont, qint64 sessionId);
 private:
 	int serverId;
 	int socketDescriptor;
@@ -51,8 +42,13 @@ private:
 	
 	QMutex outputBufferMutex;
 	Servatrice *server;
+	IslReplicator *replicator;
 	QSslSocket *socket;
 	
+	// Session ids of the peer's users, needed to route their Event_UserLeft
+	// to the same replication partition as their Event_UserJoined.
+	QHash<QString, qint64> userSessionIds;
+	
 	QByteArray inputBuffer, outputBuffer;
 	bool messageInProgress;
 	int messageLength;
@@ -68,6 +64,9 @@ private:
 	
 	void roomCommand_JoinGame(const Command_JoinGame &cmd, int cmdId, int roomId, qint64 sessionId);
 	
+	void externalUserJoined(const ServerInfo_User &userInfo);
+	void externalUserLeft(const QString &userName, qint64 sessionId);
+	
 	void processSessionEvent(const SessionEvent &event, qint64 sessionId);
 	void processRoomEvent(const RoomEvent &event);
 	void processRoomCommand(const CommandContainer &cont, qint64 sessionId);
@@ -0,0 +1,171 @@
+#include "isl_replicator.h"
+#include "servatrice.h"
+#include "servatrice_database_interface.h"
+#include "server_logger.h"
+#include "main.h"
+#include <QThread>
+
+IslReplicationPartition::IslReplicationPartition(IslReplicator *_replicator, Servatrice_DatabaseInterface *_databaseInterface)
+	: replicator(_replicator),
+	  databaseInterface(_databaseInterface),
+	  processingScheduled(false)
+{
+}
+
+IslReplicationPartition::~IslReplicationPartition()
+{
+	qDeleteAll(queue);
+	delete databaseInterface;
+	thread()->quit();
+}
+
+void IslReplicationPartition::enqueue(IslReplicationTask *task)
+{
+	QMutexLocker locker(&queueMutex);
+	queue.enqueue(task);
+	if (!processingScheduled) {
+		processingScheduled = true;
+		QMetaObject::invokeMethod(this, "processQueue", Qt::QueuedConnection);
+	}
+}
+
+void IslReplicationPartition::processQueue()
+{
+	forever {
+		queueMutex.lock();
+		if (queue.isEmpty()) {
+			processingScheduled = false;
+			queueMutex.unlock();
+			return;
+		}
+		IslReplicationTask *task = queue.dequeue();
+		queueMutex.unlock();
+
+		replicator->runTask(task);
+	}
+}
+
+IslReplicator::IslReplicator(Servatrice *_server, int numberPartitions, int _maxPendingPerPeer, int firstInstanceId, const QSqlDatabase &sqlDatabase, QObject *parent)
+	: QObject(parent),
+	  server(_server),
+	  maxPendingPerPeer(_maxPendingPerPeer),
+	  stopped(false)
+{
+	clock.start();
+
+	for (int i = 0; i < numberPartitions; ++i) {
+		Servatrice_DatabaseInterface *newDatabaseInterface = new Servatrice_DatabaseInterface(firstInstanceId + i, server);
+		IslReplicationPartition *newPartition = new IslReplicationPartition(this, newDatabaseInterface);
+
+		QThread *newThread = new QThread;
+		newThread->setObjectName("isl_replication_" + QString::number(i));
+		newPartition->moveToThread(newThread);
+		newDatabaseInterface->moveToThread(newThread);
+		server->addDatabaseInterface(newThread, newDatabaseInterface);
+
+		newThread->start();
+		QMetaObject::invokeMethod(newDatabaseInterface, "initDatabase", Qt::BlockingQueuedConnection, Q_ARG(QSqlDatabase, sqlDatabase));
+
+		partitions.append(newPartition);
+	}
+}
+
+IslReplicator::~IslReplicator()
+{
+	shutdown();
+}
+
+void IslReplicator::shutdown()
+{
+	statisticsMutex.lock();
+	if (stopped) {
+		statisticsMutex.unlock();
+		return;
+	}
+	stopped = true;
+	peerBacklogShrunk.wakeAll();
+	statisticsMutex.unlock();
+
+	for (int i = 0; i < partitions.size(); ++i) {
+		QThread *partitionThread = partitions[i]->thread();
+		partitions[i]->deleteLater(); // partition destructor calls thread()->quit()
+		partitionThread->wait();
+		delete partitionThread;
+	}
+	partitions.clear();
+}
+
+void IslReplicator::enqueue(int peerServerId, uint partitionKey, IslReplicationTask *task)
+{
+	// This function is called from the ISL interface threads. It blocks
+	// while the peer has too many unapplied items.
+
+	QMutexLocker locker(&statisticsMutex);
+	if (!stopped && (peerStatistics[peerServerId].pending >= maxPendingPerPeer)) {
+		const qint64 blockStart = clock.elapsed();
+		while (!stopped && (peerStatistics[peerServerId].pending >= maxPendingPerPeer))
+			peerBacklogShrunk.wait(&statisticsMutex);
+
+		IslPeerStatistics &stats = peerStatistics[peerServerId];
+		++stats.blockCount;
+		stats.blockedTime += clock.elapsed() - blockStart;
+	}
+	if (stopped) {
+		delete task;
+		return;
+	}
+
+	IslPeerStatistics &stats = peerStatistics[peerServerId];
+	if (++stats.pending > stats.peakPending)
+		stats.peakPending = stats.pending;
+
+	task->peerServerId = peerServerId;
+	task->enqueueTime = clock.elapsed();
+	partitions[partitionKey % partitions.size()]->enqueue(task);
+}
+
+void IslReplicator::runTask(IslReplicationTask *task)
+{
+	const qint64 lag = clock.elapsed() - task->enqueueTime;
+	task->run(server);
+
+	statisticsMutex.lock();
+	IslPeerStatistics &stats = peerStatistics[task->peerServerId];
+	++stats.processed;
+	stats.totalLag += lag;
+	if (lag > stats.maxLag)
+		stats.maxLag = lag;
+	if (--stats.pending == maxPendingPerPeer - 1)
+		peerBacklogShrunk.wakeAll();
+	statisticsMutex.unlock();
+
+	delete task;
+}
+
+void IslReplicator::logStatistics()
+{
+	QMutexLocker locker(&statisticsMutex);
+	QMutableMapIterator<int, IslPeerStatistics> statisticsIterator(peerStatistics);
+	while (statisticsIterator.hasNext()) {
+		IslPeerStatistics &stats = statisticsIterator.next().value();
+		if (!stats.processed && !stats.pending)
+			continue;
+
+		logger->logMessage(QString("[ISL] peer #%1: %2 items applied, %3 pending (peak %4), lag avg %5 ms max %6 ms, blocked %7 times for %8 ms")
+			.arg(statisticsIterator.key())
+			.arg(stats.processed)
+			.arg(stats.pending)
+			.arg(stats.peakPending)
+			.arg(stats.processed ? stats.totalLag / (qint64) stats.processed : 0)
+			.arg(stats.maxLag)
+			.arg(stats.blockCount)
+			.arg(stats.blockedTime));
+
+		stats.processed = 0;
+		stats.totalLag = 0;
+		stats.maxLag = 0;
+		stats.peakPending = stats.pending;
+		stats.blockCount = 0;
+		stats.blockedTime = 0;
+	}
+}
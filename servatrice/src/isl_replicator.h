@@ -0,0 +1,88 @@
+#ifndef ISL_REPLICATOR_H
+#define ISL_REPLICATOR_H
+
+#include <QObject>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QMap>
+#include <QList>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+
+class Server;
+class Servatrice;
+class Servatrice_DatabaseInterface;
+class IslReplicator;
+
+class IslReplicationTask {
+	friend class IslReplicator;
+private:
+	int peerServerId;
+	qint64 enqueueTime;
+public:
+	IslReplicationTask() : peerServerId(-1), enqueueTime(0) { }
+	virtual ~IslReplicationTask() { }
+	virtual void run(Server *server) = 0;
+};
+
+class IslReplicationPartition : public QObject {
+	Q_OBJECT
+private:
+	IslReplicator *replicator;
+	Servatrice_DatabaseInterface *databaseInterface;
+	QMutex queueMutex;
+	QQueue<IslReplicationTask *> queue;
+	bool processingScheduled;
+public slots:
+	void processQueue();
+public:
+	IslReplicationPartition(IslReplicator *_replicator, Servatrice_DatabaseInterface *_databaseInterface);
+	~IslReplicationPartition();
+
+	void enqueue(IslReplicationTask *task);
+};
+
+class IslPeerStatistics {
+public:
+	int pending, peakPending, blockCount;
+	quint64 processed;
+	qint64 totalLag, maxLag, blockedTime;
+	IslPeerStatistics() : pending(0), peakPending(0), blockCount(0), processed(0), totalLag(0), maxLag(0), blockedTime(0) { }
+};
+
+/*
+ * Applies events and commands received from ISL peers on a set of
+ * dedicated threads instead of the main event loop. Work is partitioned
+ * by room or session id, so that everything concerning one room or one
+ * session is applied in the order it was received. Every peer may have
+ * at most maxPendingPerPeer unapplied items; beyond that, the peer's
+ * reader thread blocks until the backlog shrinks, which in turn stops
+ * reading from its socket.
+ */
+class IslReplicator : public QObject {
+	Q_OBJECT
+private:
+	Servatrice *server;
+	int maxPendingPerPeer;
+	QList<IslReplicationPartition *> partitions;
+	QElapsedTimer clock;
+	QMutex statisticsMutex;
+	QWaitCondition peerBacklogShrunk;
+	QMap<int, IslPeerStatistics> peerStatistics;
+	bool stopped;
+
+	void enqueue(int peerServerId, uint partitionKey, IslReplicationTask *task);
+public:
+	IslReplicator(Servatrice *_server, int numberPartitions, int _maxPendingPerPeer, int firstInstanceId, const QSqlDatabase &sqlDatabase, QObject *parent = 0);
+	~IslReplicator();
+
+	void enqueueForRoom(int peerServerId, int roomId, IslReplicationTask *task) { enqueue(peerServerId, (uint) roomId, task); }
+	void enqueueForSession(int peerServerId, qint64 sessionId, IslReplicationTask *task) { enqueue(peerServerId, qHash(sessionId), task); }
+	void runTask(IslReplicationTask *task);
+	void logStatistics();
+	void shutdown();
+};
+
+#endif
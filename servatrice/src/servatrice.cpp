@@ -31,6 +31,7 @@
 #include "settingscache.h"
 #include "serversocketinterface.h"
 #include "isl_interface.h"
+#include "isl_replicator.h"
 #include "server_logger.h"
 #include "main.h"
 #include "decklist.h"
@@ -38,6 +39,18 @@
 #include "pb/event_server_shutdown.pb.h"
 #include "pb/event_connection_closed.pb.h"
 
+#ifdef Q_OS_WIN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    typedef int socklen_t;
+    typedef SOCKET NativeSocket;
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    typedef int NativeSocket;
+#endif
+
 Servatrice_GameServer::Servatrice_GameServer(Servatrice *_server, int _numberPools, const QSqlDatabase &_sqlDatabase, QObject *parent)
     : QTcpServer(parent),
       server(_server)
@@ -79,12 +92,50 @@ Servatrice_GameServer::~Servatrice_GameServer()
     }
 }
 
+static QHostAddress getSocketPeerAddress(NativeSocket socketDescriptor)
+{
+    sockaddr_storage peer;
+    socklen_t peerLength = sizeof(peer);
+    if (::getpeername(socketDescriptor, reinterpret_cast<sockaddr *>(&peer), &peerLength) != 0)
+        return QHostAddress();
+    return QHostAddress(reinterpret_cast<sockaddr *>(&peer));
+}
+
+static void rejectSocket(NativeSocket socketDescriptor, const QByteArray &message)
+{
+    // The descriptor is non-blocking and the message is tiny, so this never waits.
+    // Whatever does not fit into the send buffer is dropped.
+#ifdef MSG_NOSIGNAL
+    ::send(socketDescriptor, message.constData(), message.size(), MSG_NOSIGNAL);
+#else
+    ::send(socketDescriptor, message.constData(), message.size(), 0);
+#endif
+#ifdef Q_OS_WIN
+    ::shutdown(socketDescriptor, SD_SEND);
+    ::closesocket(socketDescriptor);
+#else
+    ::shutdown(socketDescriptor, SHUT_WR);
+    ::close(socketDescriptor);
+#endif
+}
+
 #if QT_VERSION < 0x050000
 void Servatrice_GameServer::incomingConnection(int socketDescriptor)
 #else
 void Servatrice_GameServer::incomingConnection(qintptr socketDescriptor)
 #endif
 {
+    // Enforce the per-address limits before anything is allocated for the connection.
+    const QHostAddress address = Servatrice_AddressIndex::normalize(getSocketPeerAddress((NativeSocket) socketDescriptor));
+    const bool trusted = settingsCache->getSnapshot()->trustedSources.contains(address);
+    if (!server->getAddressIndex().admitConnection(address, trusted)) {
+        if (rejectionMessage.isEmpty())
+            rejectionMessage = ServerSocketInterface::prepareConnectionRejection(server->getServerName());
+        rejectSocket((NativeSocket) socketDescriptor, rejectionMessage);
+        logger->logMessage(QString("Refused connection from %1: too many connections").arg(address.toString()));
+        return;
+    }
+
     // Determine connection pool with smallest client count
     int minClientCount = -1;
     int poolIndex = -1;
@@ -100,7 +151,8 @@ void Servatrice_GameServer::incomingConnection(qintptr socketDescriptor)
     qDebug() << "Pool utilisation:" << debugStr;
     Servatrice_ConnectionPool *pool = connectionPools[poolIndex];
 
-    ServerSocketInterface *ssi = new ServerSocketInterface(server, pool->getDatabaseInterface());
+    ServerSocketInterface *ssi = new ServerSocketInterface(server, pool->getDatabaseInterface(), address);
+    server->getAddressIndex().addClient(address, ssi);
     ssi->moveToThread(pool->thread());
     pool->addClient();
     connect(ssi, SIGNAL(destroyed()), pool, SLOT(removeClient()));
@@ -126,7 +178,7 @@ void Servatrice_IslServer::incomingConnection(qintptr socketDescriptor)
 }
 
 Servatrice::Servatrice(QObject *parent)
-    : Server(true, parent), uptime(0), shutdownTimer(0), isFirstShutdownMessage(true)
+    : Server(true, parent), islReplicator(0), uptime(0), shutdownTimer(0), isFirstShutdownMessage(true)
 {
     qRegisterMetaType<QSqlDatabase>("QSqlDatabase");
 }
@@ -134,6 +186,8 @@ Servatrice::Servatrice(QObject *parent)
 Servatrice::~Servatrice()
 {
     gameServer->close();
+    if (islReplicator)
+        islReplicator->shutdown();
     prepareDestroy();
 }
 
@@ -275,6 +329,10 @@ bool Servatrice::initServer()
     maxPlayerInactivityTime = settingsCache->value("game/max_player_inactivity_time", 15).toInt();
 
     maxUsersPerAddress = settingsCache->value("security/max_users_per_address", 4).toInt();
+    addressIndex.setLimits(maxUsersPerAddress,
+                           settingsCache->value("security/max_users_per_subnet", 0).toInt(),
+                           settingsCache->value("security/subnet_prefix_ipv4", 24).toInt(),
+                           settingsCache->value("security/subnet_prefix_ipv6", 64).toInt());
     messageCountingInterval = settingsCache->value("security/message_counting_interval", 10).toInt();
     maxMessageCountPerInterval = settingsCache->value("security/max_message_count_per_interval", 15).toInt();
     maxMessageSizePerInterval = settingsCache->value("security/max_message_size_per_interval", 1000).toInt();
@@ -282,6 +340,8 @@ bool Servatrice::initServer()
     commandCountingInterval = settingsCache->value("game/command_counting_interval", 10).toInt();
     maxCommandCountPerInterval = settingsCache->value("game/max_command_count_per_interval", 20).toInt();
 
+	const int numberPools = settingsCache->value("server/number_pools", 1).toInt();
+
 	try { if (settingsCache->value("servernetwork/active", 0).toInt()) {
 		qDebug() << "Connecting to ISL network.";
 		const QString certFileName = settingsCache->value("servernetwork/ssl_cert").toString();
@@ -309,6 +369,11 @@ bool Servatrice::initServer()
 		if (key.isNull())
 			throw QString("Invalid private key.");
 
+		const int replicationThreads = qMax(1, settingsCache->value("servernetwork/replication_threads", 2).toInt());
+		const int replicationQueueSize = qMax(1, settingsCache->value("servernetwork/replication_queue_size", 1000).toInt());
+		qDebug() << "Starting" << replicationThreads << "ISL replication threads, queue size" << replicationQueueSize;
+		islReplicator = new IslReplicator(this, replicationThreads, replicationQueueSize, qMax(numberPools, 1), servatriceDatabaseInterface->getDatabase(), this);
+
 		QMutableListIterator<ServerProperties> serverIterator(serverList);
 		while (serverIterator.hasNext()) {
 			const ServerProperties &prop = serverIterator.next();
@@ -354,7 +419,6 @@ bool Servatrice::initServer()
 		statusUpdateClock->start(statusUpdateTime);
 	}
 
-	const int numberPools = settingsCache->value("server/number_pools", 1).toInt();
 	gameServer = new Servatrice_GameServer(this, numberPools, servatriceDatabaseInterface->getDatabase(), this);
 	gameServer->setMaxPendingConnections(1000);
 	const int gamePort = settingsCache->value("server/port", 4747).toInt();
@@ -402,23 +466,22 @@ QList<ServerProperties> Servatrice::getServerList() const
 
 int Servatrice::getUsersWithAddress(const QHostAddress &address) const
 {
-    int result = 0;
-    QReadLocker locker(&clientsLock);
-    for (int i = 0; i < clients.size(); ++i)
-    if (static_cast<ServerSocketInterface *>(clients[i])->getPeerAddress() == address)
-        ++result;
-    
-    return result;
+    return addressIndex.getConnectionCount(address);
 }
 
 QList<ServerSocketInterface *> Servatrice::getUsersWithAddressAsList(const QHostAddress &address) const
 {
-    QList<ServerSocketInterface *> result;
-    QReadLocker locker(&clientsLock);
-    for (int i = 0; i < clients.size(); ++i)
-        if (static_cast<ServerSocketInterface *>(clients[i])->getPeerAddress() == address)
-            result.append(static_cast<ServerSocketInterface *>(clients[i]));
-    return result;
+    return addressIndex.getClients(address);
+}
+
+void Servatrice::removeClient(Server_ProtocolHandler *client)
+{
+    // Leave the address index before the client leaves the client list, so that
+    // whoever holds clientsLock can rely on the clients returned by the index.
+    ServerSocketInterface *ssi = static_cast<ServerSocketInterface *>(client);
+    addressIndex.removeClient(ssi->getConnectionAddress(), ssi);
+
+    Server::removeClient(client);
 }
 
 void Servatrice::updateLoginMessage()
@@ -448,6 +511,20 @@ void Servatrice::updateLoginMessage()
 
 void Servatrice::statusUpdate()
 {
+    if (islReplicator)
+        islReplicator->logStatistics();
+
+    const QMap<QString, int> floodReport = takeFloodReport();
+    if (!floodReport.isEmpty()) {
+        QStringList offenders;
+        QMapIterator<QString, int> floodIterator(floodReport);
+        while (floodIterator.hasNext()) {
+            floodIterator.next();
+            offenders.append(QString("%1 (%2)").arg(floodIterator.key()).arg(floodIterator.value()));
+        }
+        logger->logMessage(QString("Flood protection triggered by %1 users: %2").arg(floodReport.size()).arg(offenders.join(", ")));
+    }
+
     if (!servatriceDatabaseInterface->checkSql())
         return;
 
@@ -541,17 +618,8 @@ void Servatrice::addIslInterface(int serverId, IslInterface *interface)
 {
     // Only call with islLock locked for writing
 
+    // Events and commands received by the interface are applied by islReplicator.
     islInterfaces.insert(serverId, interface);
-    connect(interface, SIGNAL(externalUserJoined(ServerInfo_User)), this, SLOT(externalUserJoined(ServerInfo_User)));
-    connect(interface, SIGNAL(externalUserLeft(QString)), this, SLOT(externalUserLeft(QString)));
-    connect(interface, SIGNAL(externalRoomUserJoined(int, ServerInfo_User)), this, SLOT(externalRoomUserJoined(int, ServerInfo_User)));
-    connect(interface, SIGNAL(externalRoomUserLeft(int, QString)), this, SLOT(externalRoomUserLeft(int, QString)));
-    connect(interface, SIGNAL(externalRoomSay(int, QString, QString)), this, SLOT(externalRoomSay(int, QString, QString)));
-    connect(interface, SIGNAL(externalRoomGameListChanged(int, ServerInfo_Game)), this, SLOT(externalRoomGameListChanged(int, ServerInfo_Game)));
-    connect(interface, SIGNAL(joinGameCommandReceived(Command_JoinGame, int, int, int, qint64)), this, SLOT(externalJoinGameCommandReceived(Command_JoinGame, int, int, int, qint64)));
-    connect(interface, SIGNAL(gameCommandContainerReceived(CommandContainer, int, int, qint64)), this, SLOT(externalGameCommandContainerReceived(CommandContainer, int, int, qint64)));
-    connect(interface, SIGNAL(responseReceived(Response, qint64)), this, SLOT(externalResponseReceived(Response, qint64)));
-    connect(interface, SIGNAL(gameEventContainerReceived(GameEventContainer, qint64)), this, SLOT(externalGameEventContainerReceived(GameEventContainer, qint64)));
 }
 
 void Servatrice::removeIslInterface(int serverId)
@@ -29,6 +29,7 @@
 #include <QSqlDatabase>
 #include <QMetaType>
 #include "server.h"
+#include "servatrice_address_index.h"
 
 Q_DECLARE_METATYPE(QSqlDatabase)
 
@@ -41,12 +42,14 @@ class Servatrice_ConnectionPool;
 class Servatrice_DatabaseInterface;
 class ServerSocketInterface;
 class IslInterface;
+class IslReplicator;
 
 class Servatrice_GameServer : public QTcpServer {
 	Q_OBJECT
 private:
 	Servatrice *server;
 	QList<Servatrice_ConnectionPool *> connectionPools;
+	QByteArray rejectionMessage;
 public:
 	Servatrice_GameServer(Servatrice *_server, int _numberPools, const QSqlDatabase &_sqlDatabase, QObject *parent = 0);
 	~Servatrice_GameServer();
@@ -115,6 +118,7 @@ private:
 	QMutex txBytesMutex, rxBytesMutex;
 	quint64 txBytes, rxBytes;
 	int maxGameInactivityTime, maxPlayerInactivityTime;
+	Servatrice_AddressIndex addressIndex;
 	int maxUsersPerAddress, messageCountingInterval, maxMessageCountPerInterval, maxMessageSizePerInterval, maxGamesPerUser, commandCountingInterval, maxCommandCountPerInterval;
 
 	QString shutdownReason;
@@ -127,6 +131,7 @@ private:
 	void updateServerList();
 	
 	QMap<int, IslInterface *> islInterfaces;
+	IslReplicator *islReplicator;
 public slots:
 	void scheduleShutdown(const QString &reason, int minutes);
 	void updateLoginMessage();
@@ -151,6 +156,8 @@ public:
 	int getServerId() const { return serverId; }
 	int getUsersWithAddress(const QHostAddress &address) const;
 	QList<ServerSocketInterface *> getUsersWithAddressAsList(const QHostAddress &address) const;
+	Servatrice_AddressIndex &getAddressIndex() { return addressIndex; }
+	void removeClient(Server_ProtocolHandler *client);
 	void incTxBytes(quint64 num);
 	void incRxBytes(quint64 num);
 	void addDatabaseInterface(QThread *thread, Servatrice_DatabaseInterface *databaseInterface);
@@ -159,6 +166,7 @@ public:
 	void addIslInterface(int serverId, IslInterface *interface);
 	void removeIslInterface(int serverId);
 	QReadWriteLock islLock;
+	IslReplicator *getIslReplicator() const { return islReplicator; }
 
 	QList<ServerProperties> getServerList() const;
 };
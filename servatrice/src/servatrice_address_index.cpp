@@ -0,0 +1,102 @@
+#include "servatrice_address_index.h"
+#include <QMutexLocker>
+
+Servatrice_AddressIndex::Servatrice_AddressIndex()
+	: maxPerAddress(0),
+	  maxPerSubnet(0),
+	  ipv4SubnetPrefix(24),
+	  ipv6SubnetPrefix(64)
+{
+}
+
+void Servatrice_AddressIndex::setLimits(int _maxPerAddress, int _maxPerSubnet, int _ipv4SubnetPrefix, int _ipv6SubnetPrefix)
+{
+	QMutexLocker locker(&mutex);
+	maxPerAddress = _maxPerAddress;
+	maxPerSubnet = _maxPerSubnet;
+	ipv4SubnetPrefix = qBound(0, _ipv4SubnetPrefix, 32);
+	ipv6SubnetPrefix = qBound(0, _ipv6SubnetPrefix, 128);
+}
+
+QHostAddress Servatrice_AddressIndex::normalize(const QHostAddress &address)
+{
+	if (address.protocol() != QAbstractSocket::IPv6Protocol)
+		return address;
+
+	const Q_IPV6ADDR bytes = address.toIPv6Address();
+	for (int i = 0; i < 10; ++i)
+		if (bytes[i])
+			return address;
+	if ((bytes[10] != 0xff) || (bytes[11] != 0xff))
+		return address;
+
+	return QHostAddress(((quint32) bytes[12] << 24) | ((quint32) bytes[13] << 16) | ((quint32) bytes[14] << 8) | (quint32) bytes[15]);
+}
+
+QHostAddress Servatrice_AddressIndex::subnetOf(const QHostAddress &address) const
+{
+	if (address.protocol() == QAbstractSocket::IPv4Protocol) {
+		const quint32 mask = ipv4SubnetPrefix ? ~(quint32) 0 << (32 - ipv4SubnetPrefix) : 0;
+		return QHostAddress(address.toIPv4Address() & mask);
+	}
+
+	Q_IPV6ADDR bytes = address.toIPv6Address();
+	for (int i = 0; i < 16; ++i) {
+		const int bitsKept = qBound(0, ipv6SubnetPrefix - 8 * i, 8);
+		bytes[i] &= (quint8) (0xff00 >> bitsKept);
+	}
+	return QHostAddress(bytes);
+}
+
+bool Servatrice_AddressIndex::admitConnection(const QHostAddress &address, bool trusted)
+{
+	QMutexLocker locker(&mutex);
+	int &addressCount = connectionCountByAddress[address];
+	int &subnetCount = connectionCountBySubnet[subnetOf(address)];
+
+	if (!trusted && (((maxPerAddress > 0) && (addressCount >= maxPerAddress)) || ((maxPerSubnet > 0) && (subnetCount >= maxPerSubnet)))) {
+		if (!addressCount)
+			connectionCountByAddress.remove(address);
+		if (!subnetCount)
+			connectionCountBySubnet.remove(subnetOf(address));
+		return false;
+	}
+
+	++addressCount;
+	++subnetCount;
+	return true;
+}
+
+void Servatrice_AddressIndex::addClient(const QHostAddress &address, ServerSocketInterface *client)
+{
+	QMutexLocker locker(&mutex);
+	clientsByAddress[address].append(client);
+}
+
+void Servatrice_AddressIndex::removeClient(const QHostAddress &address, ServerSocketInterface *client)
+{
+	QMutexLocker locker(&mutex);
+	QHash<QHostAddress, QList<ServerSocketInterface *> >::iterator clientsIterator = clientsByAddress.find(address);
+	if ((clientsIterator == clientsByAddress.end()) || !clientsIterator.value().removeOne(client))
+		return;
+	if (clientsIterator.value().isEmpty())
+		clientsByAddress.erase(clientsIterator);
+
+	if (--connectionCountByAddress[address] <= 0)
+		connectionCountByAddress.remove(address);
+	const QHostAddress subnet = subnetOf(address);
+	if (--connectionCountBySubnet[subnet] <= 0)
+		connectionCountBySubnet.remove(subnet);
+}
+
+int Servatrice_AddressIndex::getConnectionCount(const QHostAddress &address) const
+{
+	QMutexLocker locker(&mutex);
+	return connectionCountByAddress.value(normalize(address));
+}
+
+QList<ServerSocketInterface *> Servatrice_AddressIndex::getClients(const QHostAddress &address) const
+{
+	QMutexLocker locker(&mutex);
+	return clientsByAddress.value(normalize(address));
+}
@@ -0,0 +1,45 @@
+#ifndef SERVATRICE_ADDRESS_INDEX_H
+#define SERVATRICE_ADDRESS_INDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QHostAddress>
+
+class ServerSocketInterface;
+
+/*
+ * Keeps track of the client connections per remote address and per subnet,
+ * so that the connection limits can be enforced when a connection is
+ * accepted without walking the list of all clients.
+ * Addresses are stored in normalized form (see normalize()).
+ */
+class Servatrice_AddressIndex {
+private:
+	mutable QMutex mutex;
+	QHash<QHostAddress, int> connectionCountByAddress, connectionCountBySubnet;
+	QHash<QHostAddress, QList<ServerSocketInterface *> > clientsByAddress;
+	int maxPerAddress, maxPerSubnet, ipv4SubnetPrefix, ipv6SubnetPrefix;
+
+	QHostAddress subnetOf(const QHostAddress &address) const;
+public:
+	Servatrice_AddressIndex();
+	void setLimits(int _maxPerAddress, int _maxPerSubnet, int _ipv4SubnetPrefix, int _ipv6SubnetPrefix);
+
+	// Counts a new connection unless this would exceed one of the limits.
+	// Connections from trusted sources are counted without checking.
+	// Called on accept, before any object is allocated for the connection.
+	bool admitConnection(const QHostAddress &address, bool trusted);
+	// The client object of an admitted connection.
+	void addClient(const QHostAddress &address, ServerSocketInterface *client);
+	// Releases the connection counted by admitConnection().
+	void removeClient(const QHostAddress &address, ServerSocketInterface *client);
+
+	int getConnectionCount(const QHostAddress &address) const;
+	QList<ServerSocketInterface *> getClients(const QHostAddress &address) const;
+
+	// Maps IPv4-mapped IPv6 addresses (::ffff:a.b.c.d) to plain IPv4.
+	static QHostAddress normalize(const QHostAddress &address);
+};
+
+#endif
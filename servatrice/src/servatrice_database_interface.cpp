@@ -120,13 +120,14 @@ bool Servatrice_DatabaseInterface::execSqlQuery(QSqlQuery *query)
 
 bool Servatrice_DatabaseInterface::usernameIsValid(const QString &user, QString & error)
 {
-    int minNameLength = settingsCache->value("users/minnamelength", 6).toInt();
-    int maxNameLength = settingsCache->value("users/maxnamelength", 12).toInt();
-    bool allowLowercase = settingsCache->value("users/allowlowercase", true).toBool();
-    bool allowUppercase = settingsCache->value("users/allowuppercase", true).toBool();
-    bool allowNumerics = settingsCache->value("users/allownumerics", true).toBool();
-    bool allowPunctuationPrefix = settingsCache->value("users/allowpunctuationprefix", false).toBool();
-    QString allowedPunctuation = settingsCache->value("users/allowedpunctuation", "_").toString();
+    const SettingsSnapshot *config = settingsCache->getSnapshot();
+    const int minNameLength = config->minNameLength;
+    const int maxNameLength = config->maxNameLength;
+    const bool allowLowercase = config->allowLowercase;
+    const bool allowUppercase = config->allowUppercase;
+    const bool allowNumerics = config->allowNumerics;
+    const bool allowPunctuationPrefix = config->allowPunctuationPrefix;
+    const QString &allowedPunctuation = config->allowedPunctuation;
     error = QString("%1|%2|%3|%4|%5|%6|%7").arg(minNameLength).arg(maxNameLength).arg(allowLowercase).arg(allowUppercase).arg(allowNumerics).arg(allowPunctuationPrefix).arg(allowedPunctuation);
 
     if (user.length() < minNameLength || user.length() > maxNameLength)
@@ -135,24 +136,15 @@ bool Servatrice_DatabaseInterface::usernameIsValid(const QString &user, QString
     if (!allowPunctuationPrefix && allowedPunctuation.contains(user.at(0)))
         return false;
 
-    QString regEx("[");
-    if (allowLowercase)
-        regEx.append("a-z");
-    if (allowUppercase)
-        regEx.append("A-Z");
-    if(allowNumerics)
-        regEx.append("0-9");
-    regEx.append(QRegExp::escape(allowedPunctuation));
-    regEx.append("]+");
-
-    static QRegExp re = QRegExp(regEx);
+    // QRegExp keeps match state, so every caller works on its own copy.
+    QRegExp re(config->userNameRegExp);
     return re.exactMatch(user);
 }
 
 // TODO move this to Server
 bool Servatrice_DatabaseInterface::getRequireRegistration()
 {
-    return settingsCache->value("authentication/regonly", 0).toBool();
+    return settingsCache->getSnapshot()->regOnly;
 }
 
 bool Servatrice_DatabaseInterface::registerUser(const QString &userName, const QString &realName, ServerInfo_User_Gender const &gender, const QString &password, const QString &emailAddress, const QString &country, QString &token, bool active)
@@ -237,8 +229,7 @@ AuthenticationResult Servatrice_DatabaseInterface::checkUserPassword(Server_Prot
     switch (server->getAuthenticationMethod()) {
     case Servatrice::AuthenticationNone: return UnknownUser;
     case Servatrice::AuthenticationPassword: {
-        QString configPassword = settingsCache->value("authentication/password").toString();
-        if (configPassword == password)
+        if (settingsCache->getSnapshot()->password == password)
             return PasswordRight;
 
         return NotLoggedIn;
@@ -730,26 +721,27 @@ DeckList *Servatrice_DatabaseInterface::getDeckFromDatabase(int deckId, int user
 
 void Servatrice_DatabaseInterface::logMessage(const int senderId, const QString &senderName, const QString &senderIp, const QString &logMessage, LogMessage_TargetType targetType, const int targetId, const QString &targetName)
 {
+    const SettingsSnapshot *config = settingsCache->getSnapshot();
     QString targetTypeString;
     switch(targetType)
     {
         case MessageTargetRoom:
-            if(!settingsCache->value("logging/log_user_msg_room", 0).toBool())
+            if(!config->logUserMsgRoom)
                 return;
             targetTypeString = "room";
             break;
         case MessageTargetGame:
-            if(!settingsCache->value("logging/log_user_msg_game", 0).toBool())
+            if(!config->logUserMsgGame)
                 return;
             targetTypeString = "game";
             break;
         case MessageTargetChat:
-            if(!settingsCache->value("logging/log_user_msg_chat", 0).toBool())
+            if(!config->logUserMsgChat)
                 return;
             targetTypeString = "chat";
             break;
         case MessageTargetIslRoom:
-            if(!settingsCache->value("logging/log_user_msg_isl", 0).toBool())
+            if(!config->logUserMsgIsl)
                 return;
             targetTypeString = "room";
             break;
@@ -54,17 +54,15 @@ void ServerLogger::logMessage(QString message, void *caller)
         callerString = QString::number((qulonglong) caller, 16) + " ";
         
     //filter out all log entries based on values in configuration file
-    bool shouldWeWriteLog = settingsCache->value("server/writelog",1).toBool();
-    QString logFilters = settingsCache->value("server/logfilters").toString();
-    QStringList listlogFilters = logFilters.split(",", QString::SkipEmptyParts); 
+    const SettingsSnapshot *config = settingsCache->getSnapshot();
     bool shouldWeSkipLine = false; 
     
-    if (!shouldWeWriteLog)
+    if (!config->writeLog)
         return;
 
-    if (!logFilters.trimmed().isEmpty()){
+    if (!config->logFilters.isEmpty()){
         shouldWeSkipLine = true;
-        foreach(QString logFilter, listlogFilters){ 
+        foreach(const QString &logFilter, config->logFilters){ 
             if (message.contains(logFilter, Qt::CaseInsensitive)){
                 shouldWeSkipLine = false;
                 break;
@@ -67,10 +67,11 @@
 
 static const int protocolVersion = 14;
 
-ServerSocketInterface::ServerSocketInterface(Servatrice *_server, Servatrice_DatabaseInterface *_databaseInterface, QObject *parent)
+ServerSocketInterface::ServerSocketInterface(Servatrice *_server, Servatrice_DatabaseInterface *_databaseInterface, const QHostAddress &_connectionAddress, QObject *parent)
     : Server_ProtocolHandler(_server, _databaseInterface, parent),
       servatrice(_server),
       sqlInterface(reinterpret_cast<Servatrice_DatabaseInterface *>(databaseInterface)),
+      connectionAddress(_connectionAddress),
       messageInProgress(false),
       handshakeStarted(false)
 {
@@ -102,6 +103,49 @@ void ServerSocketInterface::initConnection(int socketDescriptor)
     initSessionDeprecated();
 }
 
+static void appendFramedMessage(QByteArray &buf, const ServerMessage &item)
+{
+    const unsigned int size = item.ByteSize();
+    const int offset = buf.size();
+    buf.resize(offset + size + 4);
+    item.SerializeToArray(buf.data() + offset + 4, size);
+    buf.data()[offset + 3] = (unsigned char) size;
+    buf.data()[offset + 2] = (unsigned char) (size >> 8);
+    buf.data()[offset + 1] = (unsigned char) (size >> 16);
+    buf.data()[offset] = (unsigned char) (size >> 24);
+}
+
+// Everything a client is sent when its connection is refused at accept time
+// for exceeding the per-address or per-subnet limit: the stream header,
+// the server identification and the reason for closing the connection.
+QByteArray ServerSocketInterface::prepareConnectionRejection(const QString &serverName)
+{
+    QByteArray buf;
+    buf.append("<?xml version=\"1.0\"?><cockatrice_server_stream version=\"14\">");
+
+    Event_ServerIdentification identEvent;
+    identEvent.set_server_name(serverName.toStdString());
+    identEvent.set_server_version(VERSION_STRING);
+    identEvent.set_protocol_version(protocolVersion);
+    SessionEvent *identSe = prepareSessionEvent(identEvent);
+    ServerMessage identMessage;
+    identMessage.set_message_type(ServerMessage::SESSION_EVENT);
+    identMessage.mutable_session_event()->CopyFrom(*identSe);
+    delete identSe;
+    appendFramedMessage(buf, identMessage);
+
+    Event_ConnectionClosed closedEvent;
+    closedEvent.set_reason(Event_ConnectionClosed::TOO_MANY_CONNECTIONS);
+    SessionEvent *closedSe = prepareSessionEvent(closedEvent);
+    ServerMessage closedMessage;
+    closedMessage.set_message_type(ServerMessage::SESSION_EVENT);
+    closedMessage.mutable_session_event()->CopyFrom(*closedSe);
+    delete closedSe;
+    appendFramedMessage(buf, closedMessage);
+
+    return buf;
+}
+
 void ServerSocketInterface::initSessionDeprecated()
 {
     // dirty hack to make v13 client display the correct error message
@@ -122,10 +166,11 @@ bool ServerSocketInterface::initSession()
     sendProtocolItem(*identSe);
     delete identSe;
 
+	const SettingsSnapshot *config = settingsCache->getSnapshot();
+
 	//limit the number of total users based on configuration settings
-	bool enforceUserLimit = settingsCache->value("security/enable_max_user_limit", false).toBool();
-	if (enforceUserLimit){
-		int userLimit = settingsCache->value("security/max_users_total", 500).toInt();
+	if (config->enableMaxUserLimit){
+		int userLimit = config->maxUsersTotal;
 		int playerCount = (databaseInterface->getActiveUserCount() + 1);
 		if (playerCount > userLimit){
 			std::cerr << "Max Users Total Limit Reached, please increase the max_users_total setting." << std::endl;
@@ -139,21 +184,8 @@ bool ServerSocketInterface::initSession()
 		}
 	}
 
-    //allow unlimited number of connections from the trusted sources
-    QString trustedSources = settingsCache->value("security/trusted_sources","127.0.0.1,::1").toString();
-    if (trustedSources.contains(socket->peerAddress().toString(),Qt::CaseInsensitive))
-        return true;
-    
-	int maxUsers = servatrice->getMaxUsersPerAddress();
-    if ((maxUsers > 0) && (servatrice->getUsersWithAddress(socket->peerAddress()) >= maxUsers)) {
-        Event_ConnectionClosed event;
-        event.set_reason(Event_ConnectionClosed::TOO_MANY_CONNECTIONS);
-        SessionEvent *se = prepareSessionEvent(event);
-        sendProtocolItem(*se);
-        delete se;
-
-        return false;
-    }
+    // The per-address and per-subnet limits are enforced when the connection is accepted,
+    // see Servatrice_GameServer::incomingConnection().
 
     return true;
 }
@@ -248,13 +280,8 @@ void ServerSocketInterface::flushOutputQueue()
         locker.unlock();
 
         QByteArray buf;
-        unsigned int size = item.ByteSize();
-        buf.resize(size + 4);
-        item.SerializeToArray(buf.data() + 4, size);
-        buf.data()[3] = (unsigned char) size;
-        buf.data()[2] = (unsigned char) (size >> 8);
-        buf.data()[1] = (unsigned char) (size >> 16);
-        buf.data()[0] = (unsigned char) (size >> 24);
+        appendFramedMessage(buf, item);
+        const unsigned int size = buf.size() - 4;
         // In case socket->write() calls catchSocketError(), the mutex must not be locked during this call.
         socket->write(buf);
 
@@ -753,9 +780,8 @@ Response::ResponseCode ServerSocketInterface::cmdBanFromServer(const Command_Ban
 
     QString userName = QString::fromStdString(cmd.user_name());
     QString address = QString::fromStdString(cmd.address());
-    QString trustedSources = settingsCache->value("server/trusted_sources","127.0.0.1,::1").toString();
     int minutes = cmd.minutes();
-    if (trustedSources.contains(address,Qt::CaseInsensitive))
+    if (settingsCache->getSnapshot()->trustedSources.contains(QHostAddress(address)))
         address = "";
 
     QSqlQuery *query = sqlInterface->prepareQuery("insert into {prefix}_bans (user_name, ip_address, id_admin, time_from, minutes, reason, visible_reason) values(:user_name, :ip_address, :id_admin, NOW(), :minutes, :reason, :visible_reason)");
@@ -796,12 +822,12 @@ Response::ResponseCode ServerSocketInterface::cmdRegisterAccount(const Command_R
     QString userName = QString::fromStdString(cmd.user_name());
     qDebug() << "Got register command: " << userName;
 
-    bool registrationEnabled = settingsCache->value("registration/enabled", false).toBool();
-    if (!registrationEnabled)
+    const SettingsSnapshot *config = settingsCache->getSnapshot();
+    if (!config->registrationEnabled)
         return Response::RespRegistrationDisabled;
 
     QString emailAddress = QString::fromStdString(cmd.email());
-    bool requireEmailForRegistration = settingsCache->value("registration/requireemail", true).toBool();
+    bool requireEmailForRegistration = config->requireEmailForRegistration;
     if (requireEmailForRegistration)
     {
         QRegExp rx("\\b[A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\\.[A-Za-z]{2,4}\\b");
@@ -867,26 +893,25 @@ Response::ResponseCode ServerSocketInterface::cmdRegisterAccount(const Command_R
 
 bool ServerSocketInterface::sendActivationTokenMail(const QString &nickname, const QString &recipient, const QString &token)
 {
-    QString tmp = settingsCache->value("smtp/connection", "tcp").toString();
+    const SettingsSnapshot *config = settingsCache->getSnapshot();
     SmtpClient::ConnectionType connection = SmtpClient::TcpConnection;
-    if(tmp == "ssl")
+    if(config->smtpConnection == "ssl")
         connection = SmtpClient::SslConnection;
-    else if(tmp == "tls")
+    else if(config->smtpConnection == "tls")
         connection = SmtpClient::TlsConnection;
 
-    tmp = settingsCache->value("smtp/auth", "plain").toString();
     SmtpClient::AuthMethod auth = SmtpClient::AuthPlain;
-    if(tmp == "login")
+    if(config->smtpAuth == "login")
         auth = SmtpClient::AuthLogin;
 
-    QString host = settingsCache->value("smtp/host", "localhost").toString();
-    int port = settingsCache->value("smtp/port", 25).toInt();
-    QString username = settingsCache->value("smtp/username", "").toString();
-    QString password = settingsCache->value("smtp/password", "").toString();
-    QString email = settingsCache->value("smtp/email", "").toString();
-    QString name = settingsCache->value("smtp/name", "").toString();
-    QString subject = settingsCache->value("smtp/subject", "").toString();
-    QString body = settingsCache->value("smtp/body", "").toString();
+    QString host = config->smtpHost;
+    int port = config->smtpPort;
+    QString username = config->smtpUserName;
+    QString password = config->smtpPassword;
+    QString email = config->smtpEmail;
+    QString name = config->smtpName;
+    QString subject = config->smtpSubject;
+    QString body = config->smtpBody;
 
     if(email.isEmpty())
     {
@@ -1057,6 +1082,6 @@ Response::ResponseCode ServerSocketInterface::cmdShutdownServer(const Command_Sh
 Response::ResponseCode ServerSocketInterface::cmdReloadConfig(const Command_ReloadConfig & /* cmd */, ResponseContainer & /*rc*/)
 {
     logDebugMessage("Received admin command: reloading configuration");
-    settingsCache->sync();
+    settingsCache->reload();
     return Response::RespOk;
 }
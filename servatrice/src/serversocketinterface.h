@@ -70,6 +70,7 @@ private:
 	Servatrice *servatrice;
 	Servatrice_DatabaseInterface *sqlInterface;
 	QTcpSocket *socket;
+	QHostAddress connectionAddress;
 	
 	QByteArray inputBuffer;
 	QList<ServerMessage> outputQueue;
@@ -111,12 +112,15 @@ private:
 
 	bool sendActivationTokenMail(const QString &nickname, const QString &recipient, const QString &token);
 public:
-	ServerSocketInterface(Servatrice *_server, Servatrice_DatabaseInterface *_databaseInterface, QObject *parent = 0);
+	ServerSocketInterface(Servatrice *_server, Servatrice_DatabaseInterface *_databaseInterface, const QHostAddress &_connectionAddress, QObject *parent = 0);
 	~ServerSocketInterface();
+	static QByteArray prepareConnectionRejection(const QString &serverName);
 	void initSessionDeprecated();
 	bool initSession();
 	QHostAddress getPeerAddress() const { return socket->peerAddress(); }
 	QString getAddress() const { return socket->peerAddress().toString(); }
+	// The address this connection is counted under in the server's address index.
+	QHostAddress getConnectionAddress() const { return connectionAddress; }
 
 	void transmitProtocolItem(const ServerMessage &item);
 public slots:
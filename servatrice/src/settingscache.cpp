@@ -7,10 +7,82 @@
     #include <QDesktopServices>
 #endif
 
+SettingsSnapshot::SettingsSnapshot(QSettings &settings)
+{
+    writeLog = settings.value("server/writelog", 1).toBool();
+    const QStringList logFilterList = settings.value("server/logfilters").toString().split(",", QString::SkipEmptyParts);
+    for (int i = 0; i < logFilterList.size(); ++i)
+        if (!logFilterList[i].trimmed().isEmpty())
+            logFilters.append(logFilterList[i]);
+
+    enableMaxUserLimit = settings.value("security/enable_max_user_limit", false).toBool();
+    maxUsersTotal = settings.value("security/max_users_total", 500).toInt();
+    const QStringList trustedSourceList = settings.value("security/trusted_sources", "127.0.0.1,::1").toString().split(",", QString::SkipEmptyParts);
+    for (int i = 0; i < trustedSourceList.size(); ++i) {
+        QHostAddress address(trustedSourceList[i].trimmed());
+        if (!address.isNull())
+            trustedSources.insert(address);
+    }
+
+    regOnly = settings.value("authentication/regonly", 0).toBool();
+    password = settings.value("authentication/password").toString();
+
+    minNameLength = settings.value("users/minnamelength", 6).toInt();
+    maxNameLength = settings.value("users/maxnamelength", 12).toInt();
+    allowLowercase = settings.value("users/allowlowercase", true).toBool();
+    allowUppercase = settings.value("users/allowuppercase", true).toBool();
+    allowNumerics = settings.value("users/allownumerics", true).toBool();
+    allowPunctuationPrefix = settings.value("users/allowpunctuationprefix", false).toBool();
+    allowedPunctuation = settings.value("users/allowedpunctuation", "_").toString();
+
+    QString regEx("[");
+    if (allowLowercase)
+        regEx.append("a-z");
+    if (allowUppercase)
+        regEx.append("A-Z");
+    if (allowNumerics)
+        regEx.append("0-9");
+    regEx.append(QRegExp::escape(allowedPunctuation));
+    regEx.append("]+");
+    userNameRegExp = QRegExp(regEx);
+
+    registrationEnabled = settings.value("registration/enabled", false).toBool();
+    requireEmailForRegistration = settings.value("registration/requireemail", true).toBool();
+
+    logUserMsgRoom = settings.value("logging/log_user_msg_room", 0).toBool();
+    logUserMsgGame = settings.value("logging/log_user_msg_game", 0).toBool();
+    logUserMsgChat = settings.value("logging/log_user_msg_chat", 0).toBool();
+    logUserMsgIsl = settings.value("logging/log_user_msg_isl", 0).toBool();
+
+    smtpConnection = settings.value("smtp/connection", "tcp").toString();
+    smtpAuth = settings.value("smtp/auth", "plain").toString();
+    smtpHost = settings.value("smtp/host", "localhost").toString();
+    smtpPort = settings.value("smtp/port", 25).toInt();
+    smtpUserName = settings.value("smtp/username", "").toString();
+    smtpPassword = settings.value("smtp/password", "").toString();
+    smtpEmail = settings.value("smtp/email", "").toString();
+    smtpName = settings.value("smtp/name", "").toString();
+    smtpSubject = settings.value("smtp/subject", "").toString();
+    smtpBody = settings.value("smtp/body", "").toString();
+}
+
 SettingsCache::SettingsCache(const QString & fileName, QSettings::Format format, QObject * parent)
-:QSettings(fileName, format, parent)
+:QSettings(fileName, format, parent), snapshot(0)
 {
+    snapshot.fetchAndStoreOrdered(new SettingsSnapshot(*this));
+}
 
+SettingsCache::~SettingsCache()
+{
+    delete getSnapshot();
+    qDeleteAll(retiredSnapshots);
+}
+
+void SettingsCache::reload()
+{
+    QMutexLocker locker(&reloadMutex);
+    sync();
+    retiredSnapshots.append(snapshot.fetchAndStoreOrdered(new SettingsSnapshot(*this)));
 }
 
 QString SettingsCache::guessConfigurationPath(QString & specificPath)
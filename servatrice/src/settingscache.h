@@ -3,14 +3,66 @@
 
 #include <QSettings>
 #include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QList>
+#include <QHostAddress>
+#include <QRegExp>
+#include <QMutex>
+#include <QAtomicPointer>
+
+// Typed copy of the settings that are consulted while serving requests.
+// A snapshot is never modified once published; reloading the configuration
+// publishes a new one.
+class SettingsSnapshot {
+public:
+    bool writeLog;
+    QStringList logFilters;
+
+    bool enableMaxUserLimit;
+    int maxUsersTotal;
+    QSet<QHostAddress> trustedSources;
+
+    bool regOnly;
+    QString password;
+
+    int minNameLength, maxNameLength;
+    bool allowLowercase, allowUppercase, allowNumerics, allowPunctuationPrefix;
+    QString allowedPunctuation;
+    QRegExp userNameRegExp;
+
+    bool registrationEnabled, requireEmailForRegistration;
+
+    bool logUserMsgRoom, logUserMsgGame, logUserMsgChat, logUserMsgIsl;
+
+    QString smtpConnection, smtpAuth, smtpHost, smtpUserName, smtpPassword, smtpEmail, smtpName, smtpSubject, smtpBody;
+    int smtpPort;
+
+    SettingsSnapshot(QSettings &settings);
+};
 
 class SettingsCache : public QSettings {
     Q_OBJECT
 private:
     QSettings *settings;
+    QAtomicPointer<const SettingsSnapshot> snapshot;
+    // Readers never lock, so retired snapshots are kept until shutdown.
+    QList<const SettingsSnapshot *> retiredSnapshots;
+    QMutex reloadMutex;
 public:
     SettingsCache(const QString & fileName="servatrice.ini", QSettings::Format format=QSettings::IniFormat, QObject * parent = 0);
+    ~SettingsCache();
     static QString guessConfigurationPath(QString & specificPath);
+
+    const SettingsSnapshot *getSnapshot() const
+    {
+#if QT_VERSION >= 0x050000
+        return snapshot.loadAcquire();
+#else
+        return snapshot;
+#endif
+    }
+    void reload();
 };
 
 extern SettingsCache *settingsCache;
@@ -68,7 +68,7 @@ void SignalHandler::internalSigHupHandler()
     logger->logMessage("Received SIGHUP, rotating logs and reloading configuration", this);
     logger->rotateLogs();
 
-    settingsCache->sync();
+    settingsCache->reload();
     
     snHup->setEnabled(true);
 }